@@ -0,0 +1,222 @@
+#include <utility>
+#include "AvlTree.hpp"
+#include "LatencyStats.hpp"
+using namespace std;
+
+/**
+ * Default constructor
+ */
+AvlTree::AvlTree() {
+    root = nullptr;
+    count = 0;
+}
+
+/**
+ * Destructor
+ */
+AvlTree::~AvlTree() {
+    // the pool frees every node in one sweep
+    nodes.Clear();
+}
+
+// the tree is balanced, so recursion below is only O(log n) deep
+
+int AvlTree::heightOf(const Node* node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+void AvlTree::updateHeight(Node* node) {
+    node->height = 1 + max(heightOf(node->left), heightOf(node->right));
+}
+
+/**
+ * Rotate node's right child up into its place
+ *
+ * @return the new root of the subtree
+ */
+AvlTree::Node* AvlTree::rotateLeft(Node* node) {
+    Node* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+/**
+ * Rotate node's left child up into its place
+ *
+ * @return the new root of the subtree
+ */
+AvlTree::Node* AvlTree::rotateRight(Node* node) {
+    Node* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+/**
+ * Restore the AVL property at node after one of its subtrees grew or
+ * shrank by one level, with a single or double rotation
+ *
+ * @return the new root of the subtree
+ */
+AvlTree::Node* AvlTree::rebalance(Node* node) {
+    updateHeight(node);
+    const int balance = heightOf(node->left) - heightOf(node->right);
+
+    if (balance > 1) {
+        if (heightOf(node->left->left) < heightOf(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (heightOf(node->right->right) < heightOf(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+/**
+ * Add a bid below some node (recursive)
+ *
+ * @return the new root of the subtree
+ */
+AvlTree::Node* AvlTree::addNode(Node* node, Bid& bid) {
+    if (node == nullptr) {
+        return nodes.Create(move(bid));
+    }
+    if (node->bid.bidId.compare(bid.bidId) > 0) {
+        node->left = addNode(node->left, bid);
+    }
+    else {
+        node->right = addNode(node->right, bid);
+    }
+    return rebalance(node);
+}
+
+/**
+ * Unlink the smallest node below node
+ *
+ * @param min set to the unlinked node
+ * @return the new root of the subtree
+ */
+AvlTree::Node* AvlTree::removeMin(Node* node, Node*& min) {
+    if (node->left == nullptr) {
+        min = node;
+        return node->right;
+    }
+    node->left = removeMin(node->left, min);
+    return rebalance(node);
+}
+
+/**
+ * Remove the first bid with bidId below some node (recursive)
+ *
+ * @param removed set to true if a bid was removed
+ * @return the new root of the subtree
+ */
+AvlTree::Node* AvlTree::removeNode(Node* node, const string& bidId, bool& removed) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    const int cmp = bidId.compare(node->bid.bidId);
+    if (cmp < 0) {
+        node->left = removeNode(node->left, bidId, removed);
+    }
+    else if (cmp > 0) {
+        node->right = removeNode(node->right, bidId, removed);
+    }
+    else {
+        removed = true;
+        Node* left = node->left;
+        Node* right = node->right;
+        nodes.Destroy(node);
+        if (right == nullptr) {
+            return left;
+        }
+
+        // the in-order successor takes the removed node's place
+        Node* successor = nullptr;
+        right = removeMin(right, successor);
+        successor->left = left;
+        successor->right = right;
+        return rebalance(successor);
+    }
+    return rebalance(node);
+}
+
+/**
+ * Traverse the tree in order
+ */
+void AvlTree::InOrder() {
+    inOrder(root);
+}
+
+void AvlTree::inOrder(Node* node) {
+    if (node != nullptr) {
+        inOrder(node->left);
+        displayBid(node->bid);
+        inOrder(node->right);
+    }
+}
+
+/**
+ * Insert a bid
+ */
+void AvlTree::Insert(Bid bid) {
+    LatencyProbe probe(eLATENCY_AVL_TREE, eLATENCY_INSERT);
+    root = addNode(root, bid);
+    ++count;
+}
+
+/**
+ * Remove a bid
+ */
+void AvlTree::Remove(string bidId) {
+    LatencyProbe probe(eLATENCY_AVL_TREE, eLATENCY_REMOVE);
+    bool removed = false;
+    root = removeNode(root, bidId, removed);
+    if (removed) {
+        --count;
+    }
+}
+
+/**
+ * Search for a bid
+ */
+Bid AvlTree::Search(string bidId) {
+    LatencyProbe probe(eLATENCY_AVL_TREE, eLATENCY_SEARCH);
+    Node* current = root;
+    size_t visited = 0;
+    while (current != nullptr) {
+        ++visited;
+        const int cmp = bidId.compare(current->bid.bidId);
+        if (cmp == 0) {
+            probe.Work(visited);
+            return current->bid;
+        }
+        current = cmp < 0 ? current->left : current->right;
+    }
+    probe.Work(visited);
+    return Bid();
+}
+
+size_t AvlTree::Size() const {
+    return count;
+}
+
+size_t AvlTree::Height() const {
+    return heightOf(root);
+}
+
+double AvlTree::AverageDepth() const {
+    TreeShape shape = measureTree(root);
+    return shape.size == 0 ? 0.0 : double(shape.depthSum) / shape.size;
+}
@@ -0,0 +1,59 @@
+#ifndef     _AVLTREE_HPP_
+# define    _AVLTREE_HPP_
+
+# include <cstddef>
+# include <string>
+# include <utility>
+# include "Bid.hpp"
+# include "BidTree.hpp"
+# include "NodePool.hpp"
+
+/**
+ * Bid tree keyed on bidId that stays AVL-balanced: the two subtrees of
+ * every node differ in height by at most one, so Insert, Search and
+ * Remove touch at most about 1.44 log2(n) nodes whatever order the
+ * bids arrive in. Ordering and duplicate handling (equal ids go right)
+ * match BinarySearchTree.
+ */
+class AvlTree : public BidTree {
+
+private:
+    struct Node {
+        Bid bid;
+        Node* left = nullptr;
+        Node* right = nullptr;
+        int height = 1;
+
+        Node(Bid myBid) : bid(std::move(myBid)) {
+        }
+    };
+
+    Node* root;
+    std::size_t count;
+    NodePool<Node> nodes;
+
+    static int heightOf(const Node* node);
+    static void updateHeight(Node* node);
+    static Node* rotateLeft(Node* node);
+    static Node* rotateRight(Node* node);
+    static Node* rebalance(Node* node);
+
+    Node* addNode(Node* node, Bid& bid);
+    Node* removeNode(Node* node, const std::string& bidId, bool& removed);
+    Node* removeMin(Node* node, Node*& min);
+    void inOrder(Node* node);
+
+public:
+    AvlTree();
+    virtual ~AvlTree();
+    void InOrder();
+    void Insert(Bid bid);
+    void Remove(std::string bidId);
+    Bid Search(std::string bidId);
+    std::size_t Size() const;
+    std::size_t Height() const;
+    double AverageDepth() const;
+    const NodePool<Node>& Nodes() const { return nodes; }
+};
+
+#endif /*!_AVLTREE_HPP_*/
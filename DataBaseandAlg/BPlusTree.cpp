@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <utility>
+#include "BPlusTree.hpp"
+using namespace std;
+
+/**
+ * Default constructor
+ */
+BPlusTree::BPlusTree() {
+    root = nullptr;
+    firstLeaf = nullptr;
+    count = 0;
+    height = 0;
+    innerNodes = 0;
+    leafNodes = 0;
+}
+
+/**
+ * Destructor
+ */
+BPlusTree::~BPlusTree() {
+    Clear();
+}
+
+void BPlusTree::Clear() {
+    destroy(root, 1);
+    root = nullptr;
+    firstLeaf = nullptr;
+    count = 0;
+    height = 0;
+    innerNodes = 0;
+    leafNodes = 0;
+    records.clear();
+}
+
+// every leaf sits at depth height, so the level says what kind of node it is
+void BPlusTree::destroy(Node* node, size_t level) {
+    if (node == nullptr) {
+        return;
+    }
+    if (level == height) {
+        delete static_cast<LeafNode*>(node);
+        return;
+    }
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    for (int i = 0; i <= inner->count; ++i) {
+        destroy(inner->children[i], level + 1);
+    }
+    delete inner;
+}
+
+BPlusTree::LeafNode* BPlusTree::newLeaf() {
+    LeafNode* leaf = new LeafNode;
+    leaf->leaf = true;
+    leaf->count = 0;
+    leaf->next = nullptr;
+    ++leafNodes;
+    return leaf;
+}
+
+BPlusTree::InnerNode* BPlusTree::newInner() {
+    InnerNode* inner = new InnerNode;
+    inner->leaf = false;
+    inner->count = 0;
+    ++innerNodes;
+    return inner;
+}
+
+/**
+ * Insert a key below node (recursive, the tree is only a few levels
+ * deep). A full node is split in half before the key goes in.
+ *
+ * @param splitKey set to the first key of the new right sibling on a split
+ * @param splitNode set to the new right sibling on a split
+ * @return true if node was split
+ */
+bool BPlusTree::insertInto(Node* node, uint32_t key, uint32_t record, uint32_t& splitKey, Node*& splitNode) {
+    if (node->leaf) {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        LeafNode* target = leaf;
+        bool split = false;
+
+        if (leaf->count == NODE_CAPACITY) {
+            const int half = NODE_CAPACITY / 2;
+            LeafNode* right = newLeaf();
+            right->count = NODE_CAPACITY - half;
+            copy(leaf->keys + half, leaf->keys + NODE_CAPACITY, right->keys);
+            copy(leaf->records + half, leaf->records + NODE_CAPACITY, right->records);
+            leaf->count = half;
+            right->next = leaf->next;
+            leaf->next = right;
+
+            splitKey = right->keys[0];
+            splitNode = right;
+            split = true;
+            if (key >= splitKey) {
+                target = right;
+            }
+        }
+
+        // after any equal keys, so duplicates stay in insertion order
+        const int pos = int(upper_bound(target->keys, target->keys + target->count, key) - target->keys);
+        copy_backward(target->keys + pos, target->keys + target->count, target->keys + target->count + 1);
+        copy_backward(target->records + pos, target->records + target->count, target->records + target->count + 1);
+        target->keys[pos] = key;
+        target->records[pos] = record;
+        ++target->count;
+        return split;
+    }
+
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    const int child = int(upper_bound(inner->keys, inner->keys + inner->count, key) - inner->keys);
+    uint32_t childKey;
+    Node* childSplit;
+    if (!insertInto(inner->children[child], key, record, childKey, childSplit)) {
+        return false;
+    }
+    splitNode = nullptr;
+    insertIntoInner(inner, child, childKey, childSplit, splitKey, splitNode);
+    return splitNode != nullptr;
+}
+
+/**
+ * Put key at keys[pos] and child at children[pos + 1], splitting node
+ * first if it is full. On a split the middle key moves up rather than
+ * staying in either half.
+ */
+void BPlusTree::insertIntoInner(InnerNode* node, int pos, uint32_t key, Node* child,
+                                uint32_t& splitKey, Node*& splitNode) {
+    InnerNode* target = node;
+    if (node->count == NODE_CAPACITY) {
+        const int mid = NODE_CAPACITY / 2;
+        InnerNode* right = newInner();
+        right->count = NODE_CAPACITY - mid - 1;
+        copy(node->keys + mid + 1, node->keys + NODE_CAPACITY, right->keys);
+        copy(node->children + mid + 1, node->children + NODE_CAPACITY + 1, right->children);
+        node->count = mid;
+
+        splitKey = node->keys[mid];
+        splitNode = right;
+        if (pos > mid) {
+            target = right;
+            pos -= mid + 1;
+        }
+    }
+
+    copy_backward(target->keys + pos, target->keys + target->count, target->keys + target->count + 1);
+    copy_backward(target->children + pos + 1, target->children + target->count + 1,
+                  target->children + target->count + 2);
+    target->keys[pos] = key;
+    target->children[pos + 1] = child;
+    ++target->count;
+}
+
+/**
+ * Insert a bid
+ *
+ * @return false if the bid id is not a number
+ */
+bool BPlusTree::Insert(Bid bid) {
+    uint32_t key;
+    if (!bidIdToKey(bid.bidId, key)) {
+        return false;
+    }
+    const uint32_t record = uint32_t(records.size());
+    records.push_back(move(bid));
+
+    if (root == nullptr) {
+        LeafNode* leaf = newLeaf();
+        root = leaf;
+        firstLeaf = leaf;
+        height = 1;
+    }
+
+    uint32_t splitKey;
+    Node* splitNode;
+    if (insertInto(root, key, record, splitKey, splitNode)) {
+        InnerNode* newRoot = newInner();
+        newRoot->count = 1;
+        newRoot->keys[0] = splitKey;
+        newRoot->children[0] = root;
+        newRoot->children[1] = splitNode;
+        root = newRoot;
+        ++height;
+    }
+    ++count;
+    return true;
+}
+
+/**
+ * Replace the contents with bids sorted by numeric id (for example by
+ * radixSortByBidId). Leaves are packed full and each level above is
+ * built from the one below, so nothing is ever split. If the bids turn
+ * out not to be sorted they are inserted one at a time instead.
+ */
+void BPlusTree::BulkLoad(vector<Bid> bids) {
+    Clear();
+
+    vector<uint32_t> keys;
+    keys.reserve(bids.size());
+    for (const Bid& bid : bids) {
+        uint32_t key;
+        if (bidIdToKey(bid.bidId, key)) {
+            keys.push_back(key);
+        }
+    }
+    if (!is_sorted(keys.begin(), keys.end())) {
+        for (Bid& bid : bids) {
+            Insert(move(bid));
+        }
+        return;
+    }
+    if (keys.empty()) {
+        return;
+    }
+
+    records.reserve(keys.size());
+    for (Bid& bid : bids) {
+        uint32_t key;
+        if (bidIdToKey(bid.bidId, key)) {
+            records.push_back(move(bid));
+        }
+    }
+
+    // spread entries evenly so the last node of a level isn't left nearly empty
+    const size_t n = keys.size();
+    size_t nodes = (n + NODE_CAPACITY - 1) / NODE_CAPACITY;
+    vector<pair<Node*, uint32_t>> level;
+    LeafNode* previous = nullptr;
+    for (size_t i = 0; i < nodes; ++i) {
+        const size_t first = n * i / nodes;
+        const size_t last = n * (i + 1) / nodes;
+        LeafNode* leaf = newLeaf();
+        leaf->count = int(last - first);
+        for (size_t j = first; j < last; ++j) {
+            leaf->keys[j - first] = keys[j];
+            leaf->records[j - first] = uint32_t(j);
+        }
+        if (previous == nullptr) {
+            firstLeaf = leaf;
+        }
+        else {
+            previous->next = leaf;
+        }
+        previous = leaf;
+        level.push_back(make_pair(leaf, keys[first]));
+    }
+    height = 1;
+
+    // each inner node takes up to NODE_CAPACITY + 1 children; a child's
+    // smallest key becomes the separator in front of it
+    while (level.size() > 1) {
+        nodes = (level.size() + NODE_CAPACITY) / (NODE_CAPACITY + 1);
+        vector<pair<Node*, uint32_t>> parents;
+        for (size_t i = 0; i < nodes; ++i) {
+            const size_t first = level.size() * i / nodes;
+            const size_t last = level.size() * (i + 1) / nodes;
+            InnerNode* inner = newInner();
+            inner->count = int(last - first - 1);
+            for (size_t j = first; j < last; ++j) {
+                inner->children[j - first] = level[j].first;
+                if (j > first) {
+                    inner->keys[j - first - 1] = level[j].second;
+                }
+            }
+            parents.push_back(make_pair(inner, level[first].second));
+        }
+        level.swap(parents);
+        ++height;
+    }
+    root = level[0].first;
+    count = n;
+}
+
+/**
+ * Find the first entry with a key >= key
+ *
+ * @return false if there is none
+ */
+bool BPlusTree::lowerBound(uint32_t key, const LeafNode*& leaf, int& pos) const {
+    if (root == nullptr) {
+        return false;
+    }
+
+    // equal keys can sit on both sides of a separator, so go left on a tie
+    const Node* node = root;
+    while (!node->leaf) {
+        const InnerNode* inner = static_cast<const InnerNode*>(node);
+        node = inner->children[lower_bound(inner->keys, inner->keys + inner->count, key) - inner->keys];
+    }
+    leaf = static_cast<const LeafNode*>(node);
+    pos = int(lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys);
+
+    // the answer may be in a later leaf; removals can leave leaves empty
+    while (pos == leaf->count) {
+        leaf = leaf->next;
+        if (leaf == nullptr) {
+            return false;
+        }
+        pos = 0;
+    }
+    return true;
+}
+
+const Bid* BPlusTree::Find(uint32_t key) const {
+    const LeafNode* leaf;
+    int pos;
+    if (!lowerBound(key, leaf, pos) || leaf->keys[pos] != key) {
+        return nullptr;
+    }
+    return &records[leaf->records[pos]];
+}
+
+/**
+ * Search for a bid
+ */
+Bid BPlusTree::Search(string bidId) const {
+    uint32_t key;
+    const Bid* bid = nullptr;
+    if (bidIdToKey(bidId, key)) {
+        bid = Find(key);
+    }
+    return bid == nullptr ? Bid() : *bid;
+}
+
+/**
+ * Remove the first bid with bidId
+ *
+ * @return false if there was none
+ */
+bool BPlusTree::Remove(string bidId) {
+    uint32_t key;
+    const LeafNode* found;
+    int pos;
+    if (!bidIdToKey(bidId, key) || !lowerBound(key, found, pos) || found->keys[pos] != key) {
+        return false;
+    }
+
+    LeafNode* leaf = const_cast<LeafNode*>(found);
+    records[leaf->records[pos]] = Bid();
+    copy(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+    copy(leaf->records + pos + 1, leaf->records + leaf->count, leaf->records + pos);
+    --leaf->count;
+    --count;
+    return true;
+}
+
+/**
+ * Display every bid in id order by walking the leaf chain
+ */
+void BPlusTree::InOrder() const {
+    for (const LeafNode* leaf = firstLeaf; leaf != nullptr; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; ++i) {
+            displayBid(records[leaf->records[i]]);
+        }
+    }
+}
+
+size_t BPlusTree::IndexBytes() const {
+    return innerNodes * sizeof(InnerNode) + leafNodes * sizeof(LeafNode);
+}
@@ -0,0 +1,113 @@
+#ifndef     _BPLUSTREE_HPP_
+# define    _BPLUSTREE_HPP_
+
+# include <algorithm>
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+# include "Bid.hpp"
+
+/**
+ * B+-tree index over bids keyed by bidId as a uint32_t. Nodes hold up to
+ * NODE_CAPACITY keys in one array (64 keys = four cache lines), so a
+ * lookup costs one short in-node search per level instead of a cache
+ * miss per binary-tree node; with 64-way fan-out 17k bids are 3 levels
+ * deep and 10M are 4. Leaves are linked left to right for range scans.
+ *
+ * The bids themselves live in one vector; leaves store their index.
+ * Duplicate ids are kept, in insertion order. Bids whose id is not a
+ * plain number are not indexed. Remove takes the entry out of its leaf
+ * without merging underfull nodes, which keeps every lookup correct and
+ * suits a table that is mostly loaded and read.
+ */
+class BPlusTree {
+
+public:
+    static const int NODE_CAPACITY = 64;
+
+private:
+    struct Node {
+        bool leaf;
+        int count;
+        std::uint32_t keys[NODE_CAPACITY];
+    };
+
+    // count keys separate count + 1 children; children[i] holds keys < keys[i]
+    struct InnerNode : Node {
+        Node* children[NODE_CAPACITY + 1];
+    };
+
+    struct LeafNode : Node {
+        std::uint32_t records[NODE_CAPACITY];
+        LeafNode* next;
+    };
+
+    Node* root;
+    LeafNode* firstLeaf;
+    std::size_t count;
+    std::size_t height;
+    std::size_t innerNodes;
+    std::size_t leafNodes;
+    std::vector<Bid> records;
+
+    LeafNode* newLeaf();
+    InnerNode* newInner();
+    void destroy(Node* node, std::size_t level);
+    bool insertInto(Node* node, std::uint32_t key, std::uint32_t record,
+                    std::uint32_t& splitKey, Node*& splitNode);
+    void insertIntoInner(InnerNode* node, int pos, std::uint32_t key, Node* child,
+                         std::uint32_t& splitKey, Node*& splitNode);
+    bool lowerBound(std::uint32_t key, const LeafNode*& leaf, int& pos) const;
+
+public:
+    BPlusTree();
+    virtual ~BPlusTree();
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    void Clear();
+    bool Insert(Bid bid);
+    void BulkLoad(std::vector<Bid> bids);
+    void InOrder() const;
+    bool Remove(std::string bidId);
+    Bid Search(std::string bidId) const;
+    const Bid* Find(std::uint32_t key) const;
+
+    /**
+     * Call visit(bid) for every bid with low <= id <= high, in id order
+     *
+     * @return the number of bids visited
+     */
+    template <class Visit>
+    std::size_t ScanRange(std::uint32_t low, std::uint32_t high, Visit visit) const {
+        const LeafNode* leaf;
+        int pos;
+        std::size_t visited = 0;
+        if (low > high || !lowerBound(low, leaf, pos)) {
+            return 0;
+        }
+        while (leaf != nullptr) {
+            for (; pos < leaf->count; ++pos) {
+                if (leaf->keys[pos] > high) {
+                    return visited;
+                }
+                visit(records[leaf->records[pos]]);
+                ++visited;
+            }
+            leaf = leaf->next;
+            pos = 0;
+        }
+        return visited;
+    }
+
+    // number of indexed bids
+    std::size_t Size() const { return count; }
+    // levels from the root down to the leaves, 0 when empty
+    std::size_t Height() const { return height; }
+    std::size_t NodeCount() const { return innerNodes + leafNodes; }
+    // bytes held by the index nodes, not counting the bids
+    std::size_t IndexBytes() const;
+};
+
+#endif /*!_BPLUSTREE_HPP_*/
@@ -0,0 +1,589 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "AvlTree.hpp"
+#include "BPlusTree.hpp"
+#include "BenchHarness.hpp"
+#include "Bid.hpp"
+#include "BidGenerator.hpp"
+#include "BidLoader.hpp"
+#include "BinarySearchTree.hpp"
+#include "CSVreader.hpp"
+#include "HashTable.hpp"
+#include "PerfCounters.hpp"
+#include "RobinHoodHashTable.hpp"
+#include "SortEngine.hpp"
+#include "VectorSort.hpp"
+using namespace std;
+
+namespace {
+
+// dataset ids are FIRST_ID + 2k, so every odd id in between is a miss
+const unsigned FIRST_ID = 100000;
+// lookups and removals timed per trial
+const size_t QUERY_COUNT = 10000;
+// the same for a vector, where each one is a linear scan
+const size_t LINEAR_QUERY_COUNT = 200;
+// selection sort is quadratic; above this one trial takes minutes
+const size_t SELECTION_SORT_LIMIT = 20000;
+const unsigned SEED = 20161201;
+
+struct Options {
+    vector<size_t> sizes = { 1000, 10000, 100000 };
+    int trials = 5;
+    int warmup = 1;
+    bool json = true;
+    string outPath;
+    string csvPath;
+    BidGenerator::IdOrder order = BidGenerator::eIDS_SHUFFLED;
+};
+
+struct Measurement {
+    string structure;
+    string operation;
+    size_t size;
+    // operations timed per trial, for the per-operation figure
+    size_t ops;
+    vector<double> seconds;
+    // every trial gave the expected answer
+    bool valid;
+    // hardware counts summed over the timed trials
+    PerfCounters::Reading counters;
+};
+
+/**
+ * One container under test, behind a common face so every operation is
+ * timed the same way on each of them
+ */
+class Subject {
+public:
+    explicit Subject(string name) : name(move(name)) {}
+    virtual ~Subject() {}
+    // drop everything and start an empty container sized for n bids
+    virtual void Reset(size_t n) = 0;
+    virtual void Release() = 0;
+    virtual void Insert(const Bid& bid) = 0;
+    virtual bool Contains(const string& bidId) = 0;
+    virtual void Remove(const string& bidId) = 0;
+    virtual bool Removes() const { return true; }
+    virtual bool Linear() const { return false; }
+
+    const string name;
+};
+
+class VectorSubject : public Subject {
+    vector<Bid> bids;
+
+    vector<Bid>::iterator find(const string& bidId) {
+        return find_if(bids.begin(), bids.end(), [&bidId](const Bid& bid) { return bid.bidId == bidId; });
+    }
+
+public:
+    VectorSubject() : Subject("vector") {}
+    void Reset(size_t) override { bids.clear(); }
+    void Release() override { vector<Bid>().swap(bids); }
+    void Insert(const Bid& bid) override { bids.push_back(bid); }
+    bool Contains(const string& bidId) override { return find(bidId) != bids.end(); }
+    void Remove(const string& bidId) override {
+        vector<Bid>::iterator it = find(bidId);
+        if (it != bids.end()) {
+            bids.erase(it);
+        }
+    }
+    bool Linear() const override { return true; }
+};
+
+template <typename Table>
+Table* makeTable(size_t) {
+    return new Table();
+}
+
+// the legacy table keeps one bid per bucket and drops collisions, so it
+// gets a bucket for every even id in the dataset's range
+template <>
+HashTable* makeTable<HashTable>(size_t n) {
+    return new HashTable(unsigned(max<size_t>(2 * n, 1)));
+}
+
+/**
+ * Any of the keyed containers: they all take a Bid by value and hand
+ * back an empty Bid when a search misses
+ */
+template <typename Table>
+class KeyedSubject : public Subject {
+    unique_ptr<Table> table;
+    bool removes;
+
+public:
+    KeyedSubject(string name, bool removes = true) : Subject(move(name)), removes(removes) {}
+    void Reset(size_t n) override {
+        table.reset();
+        table.reset(makeTable<Table>(n));
+    }
+    void Release() override { table.reset(); }
+    void Insert(const Bid& bid) override { table->Insert(bid); }
+    bool Contains(const string& bidId) override { return !table->Search(bidId).bidId.empty(); }
+    void Remove(const string& bidId) override { table->Remove(bidId); }
+    bool Removes() const override { return removes; }
+};
+
+// opened once, the first time a measurement needs them
+PerfCounters& perfCounters() {
+    static PerfCounters perf;
+    return perf;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+bool parseCount(const string& text, size_t& value) {
+    char* end = nullptr;
+    unsigned long long parsed = strtoull(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || parsed == 0) {
+        return false;
+    }
+    value = size_t(parsed);
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], const string& defaultCsv, Options& options) {
+    options.csvPath = defaultCsv;
+    for (int i = 0; i < argc; ++i) {
+        const string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const string name = arg.substr(0, eq);
+        const string value = eq == string::npos ? string() : arg.substr(eq + 1);
+        size_t count;
+        BidGenerator::IdOrder order;
+
+        if (name == "--sizes") {
+            options.sizes.clear();
+            stringstream list(value);
+            string item;
+            while (getline(list, item, ',')) {
+                if (!parseCount(item, count)) {
+                    cerr << "Bad dataset size " << item << endl;
+                    return false;
+                }
+                options.sizes.push_back(count);
+            }
+        }
+        else if (name == "--trials" && parseCount(value, count)) {
+            options.trials = int(count);
+        }
+        else if (name == "--warmup" && (value == "0" || parseCount(value, count))) {
+            options.warmup = value == "0" ? 0 : int(count);
+        }
+        else if (name == "--format" && (value == "json" || value == "csv")) {
+            options.json = value == "json";
+        }
+        else if (name == "--out" && !value.empty()) {
+            options.outPath = value;
+        }
+        else if (name == "--order" && BidGenerator::ParseOrder(value, order)) {
+            options.order = order;
+        }
+        else if (name == "--csv" && !value.empty()) {
+            options.csvPath = value;
+        }
+        else {
+            cerr << "Unknown benchmark option " << arg << endl;
+            return false;
+        }
+    }
+    return !options.sizes.empty();
+}
+
+/**
+ * Generate a dataset of rows bids into the temp directory. Ids are
+ * FIRST_ID + 2k, so every odd id in the range is a miss; with unique ids
+ * in random order the plain binary search tree doesn't degenerate into a
+ * list the way a sorted file would make it.
+ *
+ * @return path of the new file; the caller removes it
+ */
+string writeDataset(const Options& options, size_t rows) {
+    BidGenerator::Config config;
+    config.rows = rows;
+    config.order = options.order;
+    config.firstId = FIRST_ID;
+    config.idStride = 2;
+    config.seed = SEED;
+    BidGenerator generator(options.csvPath, config);
+
+    const string path = (filesystem::temp_directory_path()
+        / ("eBid_bench_" + to_string(rows) + ".csv")).string();
+    generator.Write(path);
+    return path;
+}
+
+/**
+ * Run setup untimed and then run timed, warmup + trials times, keeping
+ * the timed trials
+ *
+ * @param run returns whether it got the expected answer
+ */
+template <typename Setup, typename Run>
+Measurement measure(const Options& options, const string& structure, const string& operation,
+                    size_t size, size_t ops, Setup setup, Run run) {
+    Measurement m{ structure, operation, size, ops, {}, true, {} };
+    PerfCounters& perf = perfCounters();
+    fill(begin(m.counters.counted), end(m.counters.counted), true);
+    cerr << "  " << structure << " " << operation << endl;
+    for (int i = 0; i < options.warmup + options.trials; ++i) {
+        setup();
+        perf.Start();
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        const bool ok = run();
+        const double seconds = secondsSince(start);
+        const PerfCounters::Reading& counters = perf.Stop();
+        m.valid = m.valid && ok;
+        if (i >= options.warmup) {
+            m.seconds.push_back(seconds);
+            m.counters.Add(counters);
+        }
+    }
+    return m;
+}
+
+void benchSubject(const Options& options, Subject& subject, const string& path, const vector<Bid>& bids,
+                  const vector<string>& hits, const vector<string>& misses, vector<Measurement>& results) {
+    const size_t n = bids.size();
+    const size_t queries = min(hits.size(), subject.Linear() ? LINEAR_QUERY_COUNT : QUERY_COUNT);
+    auto reset = [&subject, n]() { subject.Reset(n); };
+    auto build = [&subject, &bids, n]() {
+        subject.Reset(n);
+        for (const Bid& bid : bids) {
+            subject.Insert(bid);
+        }
+    };
+
+    results.push_back(measure(options, subject.name, "load", n, n, reset, [&subject, &path, n]() {
+        return streamBids(path, [&subject](Bid&& bid) { subject.Insert(bid); }) == n;
+    }));
+    results.push_back(measure(options, subject.name, "insert", n, n, reset, [&subject, &bids]() {
+        for (const Bid& bid : bids) {
+            subject.Insert(bid);
+        }
+        return true;
+    }));
+
+    // lookups leave the container alone, so one build serves every trial
+    build();
+    results.push_back(measure(options, subject.name, "search_hit", n, queries, []() {}, [&subject, &hits, queries]() {
+        size_t found = 0;
+        for (size_t i = 0; i < queries; ++i) {
+            found += subject.Contains(hits[i]);
+        }
+        return found == queries;
+    }));
+    results.push_back(measure(options, subject.name, "search_miss", n, queries, []() {}, [&subject, &misses, queries]() {
+        size_t found = 0;
+        for (size_t i = 0; i < queries; ++i) {
+            found += subject.Contains(misses[i]);
+        }
+        return found == 0;
+    }));
+
+    // with repeated ids removing one copy can leave another to find
+    const bool unique = options.order == BidGenerator::eIDS_SORTED || options.order == BidGenerator::eIDS_SHUFFLED;
+    if (subject.Removes()) {
+        bool removed = true;
+        results.push_back(measure(options, subject.name, "remove", n, queries, build, [&subject, &hits, queries]() {
+            for (size_t i = 0; i < queries; ++i) {
+                subject.Remove(hits[i]);
+            }
+            return true;
+        }));
+        // checked after the clock stopped: the last trial's bids are gone
+        for (size_t i = 0; i < queries; ++i) {
+            removed = removed && !subject.Contains(hits[i]);
+        }
+        results.back().valid = results.back().valid && (removed || !unique);
+    }
+    subject.Release();
+}
+
+void benchSorts(const Options& options, const vector<Bid>& bids, vector<Measurement>& results) {
+    const size_t n = bids.size();
+    vector<Bid> sorted;
+    auto copy = [&sorted, &bids]() { sorted = bids; };
+    auto byTitle = [&sorted]() {
+        return is_sorted(sorted.begin(), sorted.end(),
+                         [](const Bid& a, const Bid& b) { return a.title < b.title; });
+    };
+
+    if (n <= SELECTION_SORT_LIMIT) {
+        results.push_back(measure(options, "vector", "selection_sort", n, n, copy, [&sorted, &byTitle]() {
+            selectionSort(sorted);
+            return byTitle();
+        }));
+    }
+    results.push_back(measure(options, "vector", "quick_sort", n, n, copy, [&sorted, &byTitle]() {
+        quickSort(sorted, 0, int(sorted.size()) - 1);
+        return byTitle();
+    }));
+    results.push_back(measure(options, "vector", "pdq_sort", n, n, copy, [&sorted, &byTitle]() {
+        pdqSortBy(sorted.begin(), sorted.end(), BidTitleKey());
+        return byTitle();
+    }));
+    results.push_back(measure(options, "vector", "radix_sort", n, n, copy, [&sorted, &byTitle]() {
+        radixSortByTitle(sorted);
+        return byTitle();
+    }));
+    results.push_back(measure(options, "vector", "parallel_sort", n, n, copy, [&sorted, &byTitle]() {
+        parallelSort(sorted);
+        return byTitle();
+    }));
+}
+
+struct Summary {
+    double median, p95, mean, stddev, min, max;
+};
+
+Summary summarize(vector<double> seconds) {
+    sort(seconds.begin(), seconds.end());
+    const size_t count = seconds.size();
+    Summary s;
+    s.median = count % 2 ? seconds[count / 2] : (seconds[count / 2 - 1] + seconds[count / 2]) / 2;
+    // nearest rank
+    s.p95 = seconds[size_t(ceil(0.95 * count)) - 1];
+    s.mean = accumulate(seconds.begin(), seconds.end(), 0.0) / count;
+    double squares = 0;
+    for (double t : seconds) {
+        squares += (t - s.mean) * (t - s.mean);
+    }
+    s.stddev = count > 1 ? sqrt(squares / (count - 1)) : 0.0;
+    s.min = seconds.front();
+    s.max = seconds.back();
+    return s;
+}
+
+// operations counted over all the timed trials
+double perOp(const Measurement& m) {
+    return double(m.ops) * m.seconds.size();
+}
+
+string compilerName() {
+#if defined(_MSC_VER)
+    return "msvc " + to_string(_MSC_VER);
+#elif defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+string jsonString(const string& text) {
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted.push_back('\\');
+        }
+        quoted.push_back(c);
+    }
+    return quoted + "\"";
+}
+
+// times in milliseconds, plus nanoseconds per operation from the median
+void writeJson(ostream& out, const Options& options, const vector<Measurement>& results) {
+    out << "{\n"
+        << "  \"compiler\": " << jsonString(compilerName()) << ",\n"
+#ifdef NDEBUG
+        << "  \"build\": \"release\",\n"
+#else
+        << "  \"build\": \"debug\",\n"
+#endif
+        << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n"
+        << "  \"source\": " << jsonString(options.csvPath) << ",\n"
+        << "  \"id_order\": " << jsonString(BidGenerator::OrderName(options.order)) << ",\n"
+        << "  \"trials\": " << options.trials << ",\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"counters\": " << (perfCounters().Available() ? "true" : "false") << ",\n"
+        << "  \"counters_problem\": " << jsonString(perfCounters().Problem()) << ",\n"
+        << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Measurement& m = results[i];
+        const Summary s = summarize(m.seconds);
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"structure\": " << jsonString(m.structure)
+            << ", \"operation\": " << jsonString(m.operation)
+            << ", \"size\": " << m.size << ", \"ops\": " << m.ops
+            << ", \"median_ms\": " << s.median * 1e3 << ", \"p95_ms\": " << s.p95 * 1e3
+            << ", \"mean_ms\": " << s.mean * 1e3 << ", \"stddev_ms\": " << s.stddev * 1e3
+            << ", \"min_ms\": " << s.min * 1e3 << ", \"max_ms\": " << s.max * 1e3
+            << ", \"ns_per_op\": " << s.median * 1e9 / m.ops
+            << ", \"valid\": " << (m.valid ? "true" : "false");
+        // only the events that were counted, per operation
+        for (int e = 0; e < PerfCounters::eEVENT_COUNT; ++e) {
+            if (m.counters.counted[e]) {
+                out << ", \"" << PerfCounters::EventName(PerfCounters::Event(e)) << "_per_op\": "
+                    << m.counters.value[e] / perOp(m);
+            }
+        }
+        if (m.counters.IPC() != 0) {
+            out << ", \"ipc\": " << m.counters.IPC();
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void writeCsv(ostream& out, const vector<Measurement>& results) {
+    out << "structure,operation,size,ops,trials,median_ms,p95_ms,mean_ms,stddev_ms,min_ms,max_ms,ns_per_op,valid";
+    for (int e = 0; e < PerfCounters::eEVENT_COUNT; ++e) {
+        out << ',' << PerfCounters::EventName(PerfCounters::Event(e)) << "_per_op";
+    }
+    out << ",ipc\n";
+    for (const Measurement& m : results) {
+        const Summary s = summarize(m.seconds);
+        out << m.structure << ',' << m.operation << ',' << m.size << ',' << m.ops << ','
+            << m.seconds.size() << ',' << s.median * 1e3 << ',' << s.p95 * 1e3 << ','
+            << s.mean * 1e3 << ',' << s.stddev * 1e3 << ',' << s.min * 1e3 << ','
+            << s.max * 1e3 << ',' << s.median * 1e9 / m.ops << ',' << (m.valid ? 1 : 0);
+        // left empty where an event wasn't counted
+        for (int e = 0; e < PerfCounters::eEVENT_COUNT; ++e) {
+            out << ',';
+            if (m.counters.counted[e]) {
+                out << m.counters.value[e] / perOp(m);
+            }
+        }
+        out << ',';
+        if (m.counters.IPC() != 0) {
+            out << m.counters.IPC();
+        }
+        out << '\n';
+    }
+}
+}
+
+int runBenchHarness(int argc, char* argv[], const string& defaultCsv) {
+    Options options;
+    if (!parseOptions(argc, argv, defaultCsv, options)) {
+        cerr << "usage: --bench [--sizes=N,N,...] [--trials=N] [--warmup=N]"
+             << " [--format=json|csv] [--out=path] [--csv=path]"
+             << " [--order=sorted|shuffled|zipf|duplicates]" << endl;
+        return 2;
+    }
+
+    vector<Measurement> results;
+    try {
+        for (size_t n : options.sizes) {
+            cerr << "Dataset of " << n << " bids" << endl;
+            const string path = writeDataset(options, n);
+            vector<Bid> bids;
+            bids.reserve(n);
+            streamBids(path, [&bids](Bid&& bid) { bids.push_back(move(bid)); });
+
+            // hits in random order over the whole set, misses spread through the same range
+            mt19937 random(SEED);
+            vector<string> hits, misses;
+            for (const Bid& bid : bids) {
+                hits.push_back(bid.bidId);
+                if (hits.size() == QUERY_COUNT) {
+                    break;
+                }
+            }
+            shuffle(hits.begin(), hits.end(), random);
+            uniform_int_distribution<size_t> anywhere(0, n - 1);
+            for (size_t i = 0; i < hits.size(); ++i) {
+                misses.push_back(to_string(FIRST_ID + 2 * anywhere(random) + 1));
+            }
+
+            VectorSubject vectorSubject;
+            KeyedSubject<BinarySearchTree> bstSubject("binary_search_tree");
+            KeyedSubject<AvlTree> avlSubject("avl_tree");
+            KeyedSubject<BPlusTree> bplusSubject("bplus_tree");
+            // its Remove erases a bucket and shifts every later one, so it isn't timed
+            KeyedSubject<HashTable> hashSubject("hash_table", false);
+            KeyedSubject<RobinHoodHashTable> robinHoodSubject("robin_hood_hash_table");
+            Subject* subjects[] = { &vectorSubject, &bstSubject, &avlSubject, &bplusSubject,
+                                    &hashSubject, &robinHoodSubject };
+            for (Subject* subject : subjects) {
+                benchSubject(options, *subject, path, bids, hits, misses, results);
+            }
+            benchSorts(options, bids, results);
+            remove(path.c_str());
+        }
+    }
+    catch (const exception& e) {
+        cerr << "Benchmark failed: " << e.what() << endl;
+        return 1;
+    }
+
+    ofstream file;
+    if (!options.outPath.empty()) {
+        file.open(options.outPath, ios::trunc);
+        if (!file) {
+            cerr << "Failed to open " << options.outPath << endl;
+            return 1;
+        }
+    }
+    ostream& out = options.outPath.empty() ? cout : file;
+    if (options.json) {
+        writeJson(out, options, results);
+    }
+    else {
+        writeCsv(out, results);
+    }
+    return out.good() ? 0 : 1;
+}
+
+int runGenerateCommand(int argc, char* argv[], const string& defaultCsv) {
+    BidGenerator::Config config;
+    string csvPath = defaultCsv;
+    bool ok = argc >= 2 && parseCount(argv[0], config.rows);
+    for (int i = 2; ok && i < argc; ++i) {
+        const string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const string name = arg.substr(0, eq);
+        const string value = eq == string::npos ? string() : arg.substr(eq + 1);
+        size_t seed;
+
+        if (name == "--order") {
+            ok = BidGenerator::ParseOrder(value, config.order);
+        }
+        else if (name == "--seed" && parseCount(value, seed)) {
+            config.seed = seed;
+        }
+        else if (name == "--csv" && !value.empty()) {
+            csvPath = value;
+        }
+        else {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        cerr << "usage: --generate rows path [--order=sorted|shuffled|zipf|duplicates]"
+             << " [--seed=N] [--csv=path]" << endl;
+        return 2;
+    }
+
+    try {
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        BidGenerator generator(csvPath, config);
+        generator.Write(argv[1]);
+        cerr << config.rows << " bids, ids " << BidGenerator::OrderName(config.order)
+             << ", written to " << argv[1] << " in " << secondsSince(start) << " s" << endl;
+    }
+    catch (const exception& e) {
+        cerr << "Generate failed: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
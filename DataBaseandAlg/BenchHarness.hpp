@@ -0,0 +1,52 @@
+#ifndef     _BENCHHARNESS_HPP_
+# define    _BENCHHARNESS_HPP_
+
+# include <string>
+
+/**
+ * Headless benchmark run for scripts and CI, started with
+ * "DataBaseandAlg --bench [options]". A BidGenerator learns from the
+ * bundled CSV and writes a dataset of each size. Then load, insert,
+ * search (hit and miss), remove and the vector sorts are timed on every
+ * container, over warmup runs and repeated trials. For each combination
+ * the results are the median, p95, mean, standard deviation, min and max
+ * wall time, and the PerfCounters events per operation where the
+ * hardware counters can be read.
+ *
+ * Options, all optional:
+ *   --sizes=1000,10000,100000   bids in each dataset
+ *   --trials=5                  timed runs per measurement
+ *   --warmup=1                  untimed runs before them
+ *   --format=json|csv           output format, json by default
+ *   --out=path                  write there instead of stdout
+ *   --csv=path                  the CSV export to learn from
+ *   --order=shuffled            bid id order: sorted, shuffled, zipf or
+ *                               duplicates; sorted makes the plain binary
+ *                               search tree quadratic
+ *
+ * Progress goes to stderr so stdout carries only the results.
+ *
+ * @param argc number of options
+ * @param argv the options, without the program name or "--bench"
+ * @param defaultCsv CSV export used when --csv is not given
+ * @return process exit code, 0 on success
+ */
+int runBenchHarness(int argc, char* argv[], const std::string& defaultCsv);
+
+/**
+ * Write a synthetic dataset, started with
+ * "DataBaseandAlg --generate rows path [options]". See BidGenerator.
+ *
+ * Options, all optional:
+ *   --order=shuffled    sorted, shuffled, zipf or duplicates
+ *   --seed=1            same seed, same rows
+ *   --csv=path          the CSV export to learn from
+ *
+ * @param argc number of arguments
+ * @param argv rows, path and the options, without "--generate"
+ * @param defaultCsv CSV export used when --csv is not given
+ * @return process exit code, 0 on success
+ */
+int runGenerateCommand(int argc, char* argv[], const std::string& defaultCsv);
+
+#endif /*!_BENCHHARNESS_HPP_*/
@@ -0,0 +1,1768 @@
+//============================================================================
+// Name        : Benchmarks
+// Description : Timed comparisons behind the Benchmarks menu
+//============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <vector>
+#include "AvlTree.hpp"
+#include "BPlusTree.hpp"
+#include "Benchmarks.hpp"
+#include "BidGenerator.hpp"
+#include "BidLoader.hpp"
+#include "BidSnapshot.hpp"
+#include "BinarySearchTree.hpp"
+#include "CSVparser.hpp"
+#include "ConcurrentHashTable.hpp"
+#include "BidBitmapIndex.hpp"
+#include "BidColumns.hpp"
+#include "BidFilter.hpp"
+#include "BidStore.hpp"
+#include "CSVreader.hpp"
+#include "CpuFeatures.hpp"
+#include "Currency.hpp"
+#include "HashTable.hpp"
+#include "IndexSort.hpp"
+#include "IndexedBidTable.hpp"
+#include "LatencyStats.hpp"
+#include "MemoryUsage.hpp"
+#include "NodePool.hpp"
+#include "RobinHoodHashTable.hpp"
+#include "SalesAggregation.hpp"
+#include "SortEngine.hpp"
+#include "ThreadPool.hpp"
+#include "VectorSort.hpp"
+using namespace std;
+
+namespace {
+
+const csv::ScanMode SCAN_MODES[] = { csv::eSCALAR, csv::eSSE2, csv::eAVX2 };
+
+/**
+ * Seconds elapsed since start on the wall clock
+ */
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Write the header of csvPath once and then its data rows over and over
+ * until the file is at least targetBytes long
+ *
+ * @return the path of the new file
+ */
+string replicateCsv(const string& csvPath, size_t targetBytes) {
+    csv::MappedFile source(csvPath);
+    BidSnapshot::RequireCsv(source.view(), csvPath);
+    string_view text = source.view();
+    size_t headerEnd = text.find('\n');
+    if (headerEnd == string_view::npos) {
+        throw csv::Error(string("No Data in ").append(csvPath));
+    }
+    string_view header = text.substr(0, headerEnd + 1);
+    string body(text.substr(headerEnd + 1));
+    if (!body.empty() && body.back() != '\n') {
+        body.push_back('\n');
+    }
+
+    string outPath = (filesystem::temp_directory_path()
+        / ("eBid_replicated_" + to_string(targetBytes >> 20) + "MB.csv")).string();
+    ofstream out(outPath, ios::binary | ios::trunc);
+    out.write(header.data(), header.size());
+    size_t written = header.size();
+    while (written < targetBytes && !body.empty()) {
+        out.write(body.data(), body.size());
+        written += body.size();
+    }
+    if (!out) {
+        throw csv::Error(string("Failed to write ").append(outPath));
+    }
+    return outPath;
+}
+
+// a heap allocation of bytes rounded up to a typical 16-byte malloc chunk with an 8-byte header
+size_t heapChunkBytes(size_t bytes) {
+    return max<size_t>(32, (bytes + 8 + 15) / 16 * 16);
+}
+
+/**
+ * Heap bytes behind a string: nothing while it fits the small-string
+ * buffer, otherwise its capacity as one malloc chunk
+ */
+size_t stringHeapBytes(const string& s) {
+    static const size_t inlineCapacity = string().capacity();
+    if (s.capacity() <= inlineCapacity) {
+        return 0;
+    }
+    return heapChunkBytes(s.capacity() + 1);
+}
+
+size_t bidHeapBytes(const Bid& bid) {
+    return stringHeapBytes(bid.bidId) + stringHeapBytes(bid.title) + stringHeapBytes(bid.fund)
+        + stringHeapBytes(bid.department) + stringHeapBytes(bid.payStatus);
+}
+
+/**
+ * Load the bundled bids and cycle through them until there are count
+ * bids, numbering the copies 100000, 100001, ... so every id is unique
+ */
+vector<Bid> syntheticBids(const vector<Bid>& base, size_t count) {
+    vector<Bid> bids;
+    bids.reserve(count);
+    for (size_t i = 0; i < count && !base.empty(); ++i) {
+        bids.push_back(base[i % base.size()]);
+        bids.back().bidId = to_string(100000 + i);
+    }
+    return bids;
+}
+
+/**
+ * How many synthetic bids of about bytesPerBid fit in 80% of the free
+ * memory, capped at wanted
+ */
+size_t fitToMemory(size_t wanted, size_t bytesPerBid) {
+    size_t available = availableMemoryBytes();
+    if (available == 0) {
+        return wanted;
+    }
+    size_t fits = available / 10 * 8 / bytesPerBid;
+    if (fits < wanted) {
+        cout << "(only " << (available >> 20) << " MB free, using " << fits
+            << " bids instead of " << wanted << ")" << endl;
+        return fits;
+    }
+    return wanted;
+}
+
+/**
+ * Time one query over the columns and the same query over vector<Bid>
+ */
+void timeColumnQuery(const BidColumns& columns, const vector<Bid>& bids, const string& fund,
+                     int64_t aboveCents, int repeats) {
+    const int fundCode = columns.FindFund(fund);
+    AmountSummary scalar, avx2, aos;
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        aos = AmountSummary();
+        for (const Bid& bid : bids) {
+            int64_t cents = llround(bid.amount * 100);
+            if (bid.fund == fund && cents > aboveCents) {
+                ++aos.count;
+                aos.sum += cents;
+                aos.min = min(aos.min, cents);
+                aos.max = max(aos.max, cents);
+            }
+        }
+    }
+    double aosSeconds = secondsSince(start) / repeats;
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        scalar = columns.Summarize(fundCode, aboveCents, eKERNEL_SCALAR);
+    }
+    double scalarSeconds = secondsSince(start) / repeats;
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        avx2 = columns.Summarize(fundCode, aboveCents, eKERNEL_AVX2);
+    }
+    double avx2Seconds = secondsSince(start) / repeats;
+
+    start = chrono::steady_clock::now();
+    size_t filtered = 0;
+    for (int r = 0; r < repeats; ++r) {
+        filtered = columns.Filter(fundCode, aboveCents).size();
+    }
+    double filterSeconds = secondsSince(start) / repeats;
+
+    bool same = aos.count == scalar.count && aos.sum == scalar.sum && aos.min == scalar.min
+        && aos.max == scalar.max && scalar.count == avx2.count && scalar.sum == avx2.sum
+        && scalar.min == avx2.min && scalar.max == avx2.max && filtered == scalar.count;
+
+    cout << "  fund == " << fund << " and amount > " << formatCents(aboveCents) << ": "
+        << scalar.count << " rows, sum " << formatCents(scalar.sum) << ", min "
+        << (scalar.count ? formatCents(scalar.min) : "-") << ", max "
+        << (scalar.count ? formatCents(scalar.max) : "-") << (same ? "" : "  RESULTS DIFFER") << endl;
+    cout << "    vector<Bid> loop:    " << aosSeconds * 1e3 << " ms" << endl;
+    cout << "    columns, scalar:     " << scalarSeconds * 1e3 << " ms (" << aosSeconds / scalarSeconds << "x)" << endl;
+    cout << "    columns, " << (cpuHasAvx2() ? "AVX2:       " : "no AVX2:    ") << avx2Seconds * 1e3
+        << " ms (" << aosSeconds / avx2Seconds << "x)" << endl;
+    cout << "    columns, filter:     " << filterSeconds * 1e3 << " ms" << endl;
+}
+
+/**
+ * The input orders every sort benchmark runs on, built from base
+ */
+vector<pair<string, vector<Bid>>> sortInputs(const vector<Bid>& base) {
+    vector<pair<string, vector<Bid>>> inputs;
+    mt19937 rng(42);
+
+    vector<Bid> random = base;
+    shuffle(random.begin(), random.end(), rng);
+    inputs.emplace_back("random", random);
+
+    vector<Bid> sorted = base;
+    sort(sorted.begin(), sorted.end(), [](const Bid& a, const Bid& b) {
+        return a.title < b.title;
+    });
+    inputs.emplace_back("sorted", sorted);
+
+    reverse(sorted.begin(), sorted.end());
+    inputs.emplace_back("reverse-sorted", sorted);
+
+    // only 8 distinct titles
+    vector<Bid> duplicates = random;
+    for (size_t i = 0; i < duplicates.size(); ++i) {
+        duplicates[i].title = random[i % 8].title;
+    }
+    inputs.emplace_back("many-duplicates", duplicates);
+    return inputs;
+}
+
+bool sortedByTitle(const vector<Bid>& bids) {
+    return is_sorted(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) {
+        return a.title < b.title;
+    });
+}
+
+/**
+ * Run each named sort on a fresh copy of every input and print the times
+ */
+void timeSorts(const vector<pair<string, vector<Bid>>>& inputs,
+               const vector<pair<string, function<void(vector<Bid>&)>>>& sorts) {
+    for (const auto& input : inputs) {
+        cout << "  " << input.first << ":" << endl;
+        for (const auto& sorter : sorts) {
+            vector<Bid> bids = input.second;
+            auto start = chrono::steady_clock::now();
+            sorter.second(bids);
+            double seconds = secondsSince(start);
+            cout << "    " << sorter.first << ": " << seconds << " seconds"
+                << (sortedByTitle(bids) ? "" : "  NOT SORTED") << endl;
+        }
+    }
+}
+
+/**
+ * Time the record-moving sort against the permutation sorts on bids
+ */
+void timeIndexSorts(const vector<Bid>& bids) {
+    vector<Bid> moved = bids;
+    auto start = chrono::steady_clock::now();
+    pdqSortBy(moved.begin(), moved.end(), BidTitleKey());
+    double movingSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    vector<uint32_t> plainOrder = sortedIndexBy(bids, BidTitleKey());
+    double plainSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    vector<uint32_t> prefixOrder = sortedIndexByTitle(bids);
+    double prefixSeconds = secondsSince(start);
+
+    vector<Bid> permuted = bids;
+    start = chrono::steady_clock::now();
+    applyPermutation(permuted, sortedIndexByTitle(bids));
+    double applySeconds = secondsSince(start);
+
+    SortedBidView view(bids, prefixOrder);
+    bool same = true;
+    for (size_t i = 0; same && i < bids.size(); ++i) {
+        same = moved[i].title == bids[plainOrder[i]].title && moved[i].title == view[i].title
+            && moved[i].title == permuted[i].title;
+    }
+
+    cout << "    pdqSort moving records:         " << movingSeconds << " seconds" << endl;
+    cout << "    index sort, full compares:      " << plainSeconds << " seconds ("
+        << movingSeconds / plainSeconds << "x)" << endl;
+    cout << "    index sort, 8-byte prefix:      " << prefixSeconds << " seconds ("
+        << movingSeconds / prefixSeconds << "x)" << endl;
+    cout << "    prefix sort + applyPermutation: " << applySeconds << " seconds ("
+        << movingSeconds / applySeconds << "x)" << (same ? "" : "  ORDERS DIFFER") << endl;
+}
+
+/**
+ * Load bids into a fresh tree in the given order, then look every one
+ * of them up in a shuffled order, and print the load time, lookup
+ * latency and the shape the tree ended up with
+ */
+void timeTree(const string& name, function<BidTree*()> makeTree, const vector<Bid>& bids) {
+    BidTree* tree = makeTree();
+    auto start = chrono::steady_clock::now();
+    for (const Bid& bid : bids) {
+        tree->Insert(bid);
+    }
+    double loadSeconds = secondsSince(start);
+
+    vector<string> keys;
+    for (const Bid& bid : bids) {
+        keys.push_back(bid.bidId);
+    }
+    mt19937 rng(7);
+    shuffle(keys.begin(), keys.end(), rng);
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (const string& key : keys) {
+        found += !tree->Search(key).bidId.empty();
+    }
+    double searchSeconds = secondsSince(start);
+
+    cout << "    " << name << " load " << loadSeconds << " s, search " << searchSeconds * 1e9 / keys.size()
+        << " ns/lookup, height " << tree->Height() << ", average depth " << tree->AverageDepth()
+        << (found == keys.size() ? "" : "  LOOKUPS MISSED") << endl;
+    delete tree;
+}
+
+/**
+ * Build a BPlusTree, a HashTable with hashBuckets buckets and a
+ * BinarySearchTree from bids, then compare memory per key and lookups
+ * per second over every id in shuffled order. Memory counts what each
+ * structure allocates for itself; the bids' strings are left out since
+ * all three keep one copy of them per key.
+ */
+void compareIndexes(const vector<Bid>& bids, unsigned hashBuckets) {
+    vector<string> keys;
+    for (const Bid& bid : bids) {
+        keys.push_back(bid.bidId);
+    }
+    mt19937 rng(7);
+    shuffle(keys.begin(), keys.end(), rng);
+
+    vector<Bid> sorted = bids;
+    auto start = chrono::steady_clock::now();
+    radixSortByBidId(sorted);
+    BPlusTree bplus;
+    bplus.BulkLoad(move(sorted));
+    double bplusLoad = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    HashTable hashTable(hashBuckets);
+    for (const Bid& bid : bids) {
+        hashTable.Insert(bid);
+    }
+    double hashLoad = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    BinarySearchTree bst;
+    for (const Bid& bid : bids) {
+        bst.Insert(bid);
+    }
+    double bstLoad = secondsSince(start);
+
+    // Search(string) on all three so each pays for the same Bid copy
+    auto lookups = [&keys](function<Bid(const string&)> search, size_t& found) {
+        found = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string& key : keys) {
+            found += search(key).bidId == key;
+        }
+        return keys.size() / secondsSince(start);
+    };
+    size_t bplusFound, hashFound, bstFound;
+    double bplusRate = lookups([&bplus](const string& key) { return bplus.Search(key); }, bplusFound);
+    double hashRate = lookups([&hashTable](const string& key) { return hashTable.Search(key); }, hashFound);
+    double bstRate = lookups([&bst](const string& key) { return bst.Search(key); }, bstFound);
+
+    const double n = double(bids.size());
+    const double bplusBytes = double(bplus.IndexBytes() + heapChunkBytes(bplus.Size() * sizeof(Bid)));
+    const double bstBytes = double(bst.Size() * heapChunkBytes(sizeof(Node)));
+    cout << "    BPlusTree         load " << bplusLoad << " s, " << bplusBytes / n << " bytes/key ("
+        << double(bplus.IndexBytes()) / n << " in index nodes), " << bplusRate << " lookups/s, found "
+        << bplusFound << ", height " << bplus.Height() << endl;
+    cout << "    HashTable         load " << hashLoad << " s, " << double(hashTable.MemoryBytes()) / n
+        << " bytes/key, " << hashRate << " lookups/s, found " << hashFound << endl;
+    cout << "    BinarySearchTree  load " << bstLoad << " s, " << bstBytes / n << " bytes/key, "
+        << bstRate << " lookups/s, found " << bstFound << ", height " << bst.Height() << endl;
+
+    // ranges of 1000 ids each, starting anywhere in the id space
+    uint32_t low = UINT32_MAX, high = 0;
+    for (const Bid& bid : bids) {
+        uint32_t key;
+        if (bidIdToKey(bid.bidId, key)) {
+            low = min(low, key);
+            high = max(high, key);
+        }
+    }
+    if (low <= high) {
+        const int SCANS = 1000;
+        uniform_int_distribution<uint32_t> from(low, high);
+        size_t visited = 0;
+        double amount = 0.0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < SCANS; ++i) {
+            uint32_t first = from(rng);
+            visited += bplus.ScanRange(first, first + 999, [&amount](const Bid& bid) { amount += bid.amount; });
+        }
+        double seconds = secondsSince(start);
+        cout << "    BPlusTree range scans of 1000 ids: " << seconds * 1e6 / SCANS << " us/scan, "
+            << visited / seconds << " bids/s" << endl;
+    }
+}
+
+/**
+ * Print how many entries sit at each distance from their home slot, one
+ * '#' per 2% of the entries
+ */
+void printProbeHistogram(const vector<size_t>& histogram) {
+    size_t total = 0;
+    for (size_t count : histogram) {
+        total += count;
+    }
+    for (size_t d = 0; d < histogram.size(); ++d) {
+        const double percent = 100.0 * histogram[d] / total;
+        cout << "      " << (d < 10 ? " " : "") << d << ": " << histogram[d] << " (" << percent << "%) "
+            << string(size_t(percent / 2 + 0.5), '#') << endl;
+    }
+}
+
+/**
+ * Insert bids into the old chained HashTable with hashBuckets buckets and
+ * into a RobinHoodHashTable that starts small and grows, then look
+ * every id up again in shuffled order. Each table is gone before the
+ * next one is built.
+ */
+void compareHashTables(const vector<Bid>& bids, unsigned hashBuckets) {
+    vector<string> keys;
+    vector<uint32_t> numericKeys;
+    for (const Bid& bid : bids) {
+        keys.push_back(bid.bidId);
+    }
+    mt19937 rng(7);
+    shuffle(keys.begin(), keys.end(), rng);
+    for (const string& key : keys) {
+        uint32_t numeric = 0;
+        bidIdToKey(key, numeric);
+        numericKeys.push_back(numeric);
+    }
+    const double n = double(bids.size());
+
+    {
+        HashTable table(hashBuckets);
+        auto start = chrono::steady_clock::now();
+        for (const Bid& bid : bids) {
+            table.Insert(bid);
+        }
+        double insertSeconds = secondsSince(start);
+
+        size_t found = 0;
+        start = chrono::steady_clock::now();
+        for (const string& key : keys) {
+            found += table.Search(key).bidId == key;
+        }
+        double searchSeconds = secondsSince(start);
+        cout << "    HashTable (" << hashBuckets << " buckets): " << n / insertSeconds / 1e6 << " M inserts/s, "
+            << n / searchSeconds / 1e6 << " M lookups/s, found " << found << " of " << keys.size() << endl;
+    }
+    {
+        RobinHoodHashTable table;
+        auto start = chrono::steady_clock::now();
+        for (const Bid& bid : bids) {
+            table.Insert(bid);
+        }
+        double insertSeconds = secondsSince(start);
+
+        size_t found = 0;
+        start = chrono::steady_clock::now();
+        for (const string& key : keys) {
+            found += table.Search(key).bidId == key;
+        }
+        double searchSeconds = secondsSince(start);
+
+        // Find skips parsing the id and copying the bid out
+        size_t foundByKey = 0;
+        start = chrono::steady_clock::now();
+        for (uint32_t key : numericKeys) {
+            foundByKey += table.Find(key) != nullptr;
+        }
+        double findSeconds = secondsSince(start);
+
+        size_t misses = 0;
+        start = chrono::steady_clock::now();
+        for (uint32_t key : numericKeys) {
+            misses += table.Find(key + 0x80000000u) == nullptr;
+        }
+        double missSeconds = secondsSince(start);
+
+        cout << "    RobinHoodHashTable: " << n / insertSeconds / 1e6 << " M inserts/s (growing from "
+            << RobinHoodHashTable().Capacity() << " slots), " << n / searchSeconds / 1e6 << " M lookups/s, found "
+            << found << endl;
+        cout << "      Find by number: " << n / findSeconds / 1e6 << " M hits/s (" << foundByKey << " found), "
+            << n / missSeconds / 1e6 << " M misses/s (" << misses << " missed)" << endl;
+        cout << "      " << table.Capacity() << " slots, load factor " << table.LoadFactor() << ", "
+            << double(table.MemoryBytes()) / table.Size() << " bytes/key; distance from home slot:" << endl;
+        printProbeHistogram(table.ProbeHistogram());
+    }
+}
+
+/**
+ * Insert count ids into a RobinHoodHashTable that starts at 1024 slots,
+ * timing every Insert on its own, and print the latency percentiles.
+ * The bid is built before the clock starts, so only the table is timed.
+ */
+void timeInsertLatency(const string& name, RehashMode mode, size_t count) {
+    vector<uint32_t> nanoseconds;
+    nanoseconds.reserve(count);
+    double totalSeconds;
+    size_t capacity;
+    {
+        RobinHoodHashTable table(0.875, 1024, mode);
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            Bid bid;
+            bid.bidId = to_string(100000 + i);
+            auto start = chrono::steady_clock::now();
+            table.Insert(move(bid));
+            auto elapsed = chrono::steady_clock::now() - start;
+            nanoseconds.push_back(uint32_t(min<long long>(
+                chrono::duration_cast<chrono::nanoseconds>(elapsed).count(), UINT32_MAX)));
+        }
+        totalSeconds = secondsSince(begin);
+        capacity = table.Capacity();
+    }
+
+    size_t overMillisecond = 0;
+    for (uint32_t ns : nanoseconds) {
+        overMillisecond += ns > 1000000;
+    }
+    sort(nanoseconds.begin(), nanoseconds.end());
+    auto percentile = [&nanoseconds](double p) {
+        return nanoseconds[min(nanoseconds.size() - 1, size_t(p / 100 * nanoseconds.size()))];
+    };
+    cout << "    " << name << ": " << totalSeconds << " seconds, " << capacity << " slots at the end" << endl;
+    cout << "      insert latency p50 " << percentile(50) << " ns, p99 " << percentile(99) << " ns, p99.9 "
+        << percentile(99.9) << " ns, max " << double(nanoseconds.back()) / 1e6 << " ms; "
+        << overMillisecond << " inserts over 1 ms" << endl;
+}
+
+/**
+ * A bid whose every field says which id and which writer round made
+ * it, so a reader can tell a torn or misplaced copy from a good one
+ */
+Bid stressBid(uint32_t key, unsigned round) {
+    Bid bid;
+    bid.bidId = to_string(key);
+    bid.title = "bid " + bid.bidId + " round " + to_string(round);
+    bid.fund = to_string(round);
+    bid.amount = double(key);
+    return bid;
+}
+
+bool isStressBid(const Bid& bid, uint32_t key) {
+    const unsigned round = unsigned(atoi(bid.fund.c_str()));
+    return bid.bidId == to_string(key) && bid.amount == double(key)
+        && bid.title == "bid " + bid.bidId + " round " + to_string(round);
+}
+
+/**
+ * Writers each own the ids that are equal to their number modulo the
+ * writer count. Every round they insert all of their ids again, then
+ * remove a third of them, while readers search random ids and check
+ * every bid they get back. At the end the table must hold exactly what
+ * the last round left.
+ *
+ * @return false on any bad read or a wrong final state
+ */
+bool stressConcurrentHashTable(unsigned writers, unsigned readers, uint32_t keys, unsigned rounds) {
+    ConcurrentHashTable table;
+    atomic<unsigned> writersLeft(writers);
+    atomic<size_t> badReads(0);
+    atomic<size_t> reads(0);
+
+    ThreadPool pool(writers + readers);
+    for (unsigned w = 0; w < writers; ++w) {
+        pool.Submit([&, w]() {
+            for (unsigned round = 0; round < rounds; ++round) {
+                for (uint32_t key = w; key < keys; key += writers) {
+                    table.Insert(stressBid(key, round));
+                }
+                for (uint32_t key = w; key < keys; key += writers) {
+                    if ((key + round) % 3 == 0) {
+                        table.Remove(to_string(key));
+                    }
+                }
+            }
+            --writersLeft;
+        });
+    }
+    for (unsigned r = 0; r < readers; ++r) {
+        pool.Submit([&, r]() {
+            mt19937 rng(r);
+            size_t done = 0;
+            while (writersLeft > 0) {
+                const uint32_t key = rng() % keys;
+                Bid bid = table.Search(to_string(key));
+                if (!bid.bidId.empty() && !isStressBid(bid, key)) {
+                    ++badReads;
+                }
+                ++done;
+            }
+            reads += done;
+        });
+    }
+    pool.Wait();
+
+    size_t wrongFinal = 0;
+    size_t expected = 0;
+    for (uint32_t key = 0; key < keys; ++key) {
+        Bid bid = table.Search(to_string(key));
+        if ((key + rounds - 1) % 3 == 0) {
+            wrongFinal += !bid.bidId.empty();
+        }
+        else {
+            ++expected;
+            wrongFinal += !isStressBid(bid, key) || bid.fund != to_string(rounds - 1);
+        }
+    }
+    wrongFinal += table.Size() != expected;
+    cout << "  stress check, " << writers << " writers and " << readers << " readers: " << reads
+        << " reads, " << badReads << " bad reads, " << wrongFinal << " wrong entries at the end: "
+        << (badReads == 0 && wrongFinal == 0 ? "ok" : "FAILED") << endl;
+    return badReads == 0 && wrongFinal == 0;
+}
+
+/**
+ * Split totalOps random operations on ids below keyRange over threads,
+ * readPercent of them Search and the rest Insert and Remove in equal
+ * numbers, so the table stays about as full as it started
+ *
+ * @return million operations per second
+ */
+double mixedOpsThroughput(ConcurrentHashTable& table, unsigned threads, unsigned readPercent,
+                          uint32_t keyRange, size_t totalOps) {
+    ThreadPool pool(threads);
+    auto start = chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.Submit([&, t]() {
+            mt19937 rng(1000 + t);
+            const size_t ops = totalOps / threads;
+            for (size_t i = 0; i < ops; ++i) {
+                const uint32_t key = rng() % keyRange;
+                const unsigned dice = rng() % 200;
+                if (dice < readPercent * 2) {
+                    table.Search(to_string(key));
+                }
+                else if (dice % 2 == 0) {
+                    table.Insert(stressBid(key, 0));
+                }
+                else {
+                    table.Remove(to_string(key));
+                }
+            }
+        });
+    }
+    pool.Wait();
+    return totalOps / threads * threads / secondsSince(start) / 1e6;
+}
+
+/**
+ * Print lookups/s for search(id) called once per id, then for
+ * searchBatch over consecutive runs of each batch size. Every bid found
+ * is read, so a batch gets no credit for skipping the bid itself.
+ */
+void timeBatchLookups(const vector<uint32_t>& ids, function<bool(uint32_t)> search,
+                      function<void(const uint32_t*, size_t, const Bid**)> searchBatch) {
+    const size_t n = ids.size();
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t id : ids) {
+        found += search(id);
+    }
+    double seconds = secondsSince(start);
+    cout << "      Search in a loop: " << n / seconds / 1e6 << " M lookups/s (" << found << " found)" << endl;
+
+    vector<const Bid*> out(n);
+    double oneAtATime = 0.0;
+    const size_t batchSizes[] = { 1, 8, 32, 256 };
+    for (size_t batch : batchSizes) {
+        found = 0;
+        start = chrono::steady_clock::now();
+        for (size_t first = 0; first < n; first += batch) {
+            const size_t count = min(batch, n - first);
+            searchBatch(&ids[first], count, &out[first]);
+            for (size_t i = first; i < first + count; ++i) {
+                found += out[i] != nullptr && !out[i]->bidId.empty();
+            }
+        }
+        seconds = secondsSince(start);
+        if (batch == 1) {
+            oneAtATime = seconds;
+        }
+        cout << "      SearchBatch of " << setw(3) << batch << ": " << n / seconds / 1e6 << " M lookups/s, "
+            << oneAtATime / seconds << "x batch of 1 (" << found << " found)" << endl;
+    }
+}
+
+/**
+ * Build a BidBitmapIndex over bids, then time filters answered from it
+ * against a scan of the vector testing every bid, and check both found
+ * the same rows
+ */
+void compareBitmapFilters(const vector<Bid>& bids) {
+    auto start = chrono::steady_clock::now();
+    const BidBitmapIndex index(bids);
+    const double buildSeconds = secondsSince(start);
+    size_t bidBytes = bids.size() * sizeof(Bid);
+    for (const Bid& bid : bids) {
+        bidBytes += bidHeapBytes(bid);
+    }
+    cout << "    index built in " << buildSeconds << " s, " << double(index.MemoryBytes()) / bids.size()
+        << " bytes/bid against " << double(bidBytes) / bids.size() << " for vector<Bid>" << endl;
+
+    const char* const queries[] = {
+        "fund=\"General Fund\"",
+        "department=\"DRUG TASK FORCE\" and fund=Enterprise",
+        "department=ITS or department=HEALTH or department=\"POLICE DEPARTMENT\"",
+        "not fund=\"General Fund\" and not department=\"SCHOOL BOARD WAREHOUSE\"",
+        "paystatus=Successful and department=\"GENERAL SERVICES\" and not fund=Enterprise"
+    };
+    const int repeats = int(max<size_t>(3, 2000000 / max<size_t>(bids.size(), 1)));
+    for (const char* text : queries) {
+        BidFilter filter;
+        string problem;
+        BidFilter::Parse(text, filter, problem);
+
+        size_t indexed = 0;
+        vector<uint32_t> rows;
+        vector<const Bid*> matches;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            indexed = index.Rows(filter).Cardinality();
+        }
+        const double bitmapSeconds = secondsSince(start) / repeats;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            rows.clear();
+            matches.clear();
+            index.Rows(filter).AppendTo(rows);
+            for (uint32_t row : rows) {
+                matches.push_back(&bids[row]);
+            }
+        }
+        const double materializeSeconds = secondsSince(start) / repeats;
+
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            matches.clear();
+            for (const Bid& bid : bids) {
+                if (filter.Matches(bid)) {
+                    matches.push_back(&bid);
+                }
+            }
+        }
+        const double scanSeconds = secondsSince(start) / repeats;
+
+        cout << "    " << filter.ToString() << endl;
+        cout << "      " << setw(9) << indexed << " bids: bitmaps " << setw(10) << bitmapSeconds * 1e6
+            << " us, with bids " << setw(10) << materializeSeconds * 1e6 << " us, scan " << setw(10)
+            << scanSeconds * 1e6 << " us, " << scanSeconds / materializeSeconds << "x"
+            << (indexed == matches.size() ? "" : " MISMATCH") << endl;
+    }
+}
+
+/**
+ * Time each kind of secondary index query against a full scan that
+ * answers the same question, and check both found the same bids
+ */
+void compareIndexQueries(const IndexedBidTable& table) {
+    struct Query {
+        string name;
+        function<vector<const Bid*>()> indexed;
+        function<bool(const Bid&)> matches;
+    };
+    const vector<Query> queries = {
+        { "fund = General Fund", [&table] { return table.InFund("General Fund"); },
+          [](const Bid& bid) { return bid.fund == "General Fund"; } },
+        { "amount 500..1000", [&table] { return table.AmountBetween(500, 1000); },
+          [](const Bid& bid) { return bid.amount >= 500 && bid.amount <= 1000; } },
+        { "amount >= 100000", [&table] { return table.AmountBetween(100000, 1e300); },
+          [](const Bid& bid) { return bid.amount >= 100000; } },
+        { "title starts Dell", [&table] { return table.TitleStartsWith("Dell"); },
+          [](const Bid& bid) { return bid.title.compare(0, 4, "Dell") == 0; } },
+        { "title starts Desk", [&table] { return table.TitleStartsWith("Desk"); },
+          [](const Bid& bid) { return bid.title.compare(0, 4, "Desk") == 0; } }
+    };
+    // enough repeats that the small file takes measurable time
+    const int repeats = int(max<size_t>(3, 2000000 / max<size_t>(table.Size(), 1)));
+
+    for (const Query& query : queries) {
+        size_t indexed = 0, scanned = 0;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            indexed = query.indexed().size();
+        }
+        const double indexSeconds = secondsSince(start) / repeats;
+
+        vector<const Bid*> matches;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            matches.clear();
+            table.ForEach([&query, &matches](const Bid& bid) {
+                if (query.matches(bid)) {
+                    matches.push_back(&bid);
+                }
+            });
+        }
+        const double scanSeconds = secondsSince(start) / repeats;
+        scanned = matches.size();
+
+        cout << "    " << left << setw(20) << query.name << right << setw(9) << indexed << " bids: index "
+            << setw(10) << indexSeconds * 1e6 << " us, scan " << setw(10) << scanSeconds * 1e6 << " us, "
+            << scanSeconds / indexSeconds << "x" << (indexed == scanned ? "" : " MISMATCH") << endl;
+    }
+}
+
+/**
+ * Time every grouping of the columns three ways: the std::map reference,
+ * aggregateSales on one thread and on every core, checking the totals
+ * agree to the cent
+ */
+void compareAggregation(const SalesColumns& columns) {
+    const unsigned threads = ThreadPool::DefaultThreads();
+    const int repeats = int(max<size_t>(1, 2000000 / max<size_t>(columns.Size(), 1)));
+    for (int g = 0; g < eGROUPS; ++g) {
+        const SalesGroup group = SalesGroup(g);
+        vector<SalesTotals> reference, single, parallel;
+
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            reference = aggregateSalesReference(columns, group);
+        }
+        const double referenceSeconds = secondsSince(start) / repeats;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            single = aggregateSales(columns, group, 1);
+        }
+        const double singleSeconds = secondsSince(start) / repeats;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            parallel = aggregateSales(columns, group, threads);
+        }
+        const double parallelSeconds = secondsSince(start) / repeats;
+
+        const double rows = double(columns.Size()) / 1e6;
+        cout << "    by " << left << setw(11) << salesGroupName(group) << right << setw(6) << reference.size()
+            << " groups: map " << setw(8) << rows / referenceSeconds << " M rows/s, hash " << setw(8)
+            << rows / singleSeconds << " M rows/s, " << threads << " threads " << setw(8)
+            << rows / parallelSeconds << " M rows/s, " << referenceSeconds / parallelSeconds << "x"
+            << (single == reference && parallel == reference ? "" : " MISMATCH") << endl;
+    }
+}
+}
+
+bool verifyTokenizer(const string& csvPath) {
+    csv::MappedFile file(csvPath);
+    BidSnapshot::RequireCsv(file.view(), csvPath);
+    csv::Parser parser = csv::Parser(csvPath);
+    bool allMatch = true;
+
+    for (csv::ScanMode mode : SCAN_MODES) {
+        if (!csv::scanModeSupported(mode)) {
+            cout << "  " << csv::scanModeName(mode) << ": not supported on this CPU" << endl;
+            continue;
+        }
+
+        csv::Reader reader(file.view(), ',', mode);
+        vector<string_view> fields;
+        unsigned int row = 0;
+        bool match = reader.next(fields); // header
+
+        while (match && reader.next(fields)) {
+            if (row >= parser.rowCount() || fields.size() != parser[row].size()) {
+                match = false;
+                break;
+            }
+            for (unsigned int k = 0; k < fields.size(); ++k) {
+                if (fields[k] != parser[row][k]) {
+                    match = false;
+                    break;
+                }
+            }
+            ++row;
+        }
+        match = match && row == parser.rowCount();
+
+        cout << "  " << csv::scanModeName(mode) << ": " << (match ? "identical to" : "DIFFERS from")
+            << " csv::Parser after " << row << " rows" << endl;
+        allMatch = allMatch && match;
+    }
+    return allMatch;
+}
+
+void benchTokenizer(const string& csvPath, size_t targetBytes) {
+    string bigPath = replicateCsv(csvPath, targetBytes);
+
+    {
+        csv::MappedFile file(bigPath);
+        cout << "Tokenizing " << bigPath << " (" << (file.size() >> 20) << " MB)" << endl;
+
+        for (csv::ScanMode mode : SCAN_MODES) {
+            if (!csv::scanModeSupported(mode)) {
+                continue;
+            }
+
+            // first pass faults the pages in, the second one is timed
+            size_t records = 0;
+            size_t fieldCount = 0;
+            double seconds = 0.0;
+            for (int pass = 0; pass < 2; ++pass) {
+                csv::Reader reader(file.view(), ',', mode);
+                vector<string_view> fields;
+                records = 0;
+                fieldCount = 0;
+
+                auto start = chrono::steady_clock::now();
+                while (reader.next(fields)) {
+                    ++records;
+                    fieldCount += fields.size();
+                }
+                seconds = secondsSince(start);
+            }
+
+            cout << "  " << csv::scanModeName(mode) << ": " << records << " records, "
+                << fieldCount << " fields, " << seconds << " seconds, "
+                << (file.size() / 1048576.0) / seconds << " MB/s" << endl;
+        }
+    }
+
+    remove(bigPath.c_str());
+}
+
+void benchParallelLoad(const string& csvPath, size_t targetBytes) {
+    string bigPath = replicateCsv(csvPath, targetBytes);
+
+    vector<Bid> reference;
+    auto start = chrono::steady_clock::now();
+    streamBids(bigPath, [&reference](Bid&& bid) {
+        reference.push_back(move(bid));
+    });
+    double sequential = secondsSince(start);
+    cout << "sequential mapped loader: " << reference.size() << " bids, "
+        << sequential << " seconds" << endl;
+
+    vector<unsigned> threadCounts;
+    const unsigned maxThreads = ThreadPool::DefaultThreads();
+    for (unsigned t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned threads : threadCounts) {
+        start = chrono::steady_clock::now();
+        vector<Bid> bids = loadBidsParallel(bigPath, threads);
+        double seconds = secondsSince(start);
+
+        bool sameOrder = bids.size() == reference.size();
+        for (size_t i = 0; sameOrder && i < bids.size(); ++i) {
+            sameOrder = bids[i].bidId == reference[i].bidId && bids[i].title == reference[i].title;
+        }
+        cout << "  " << threads << " threads: " << seconds << " seconds, speedup "
+            << sequential / seconds << "x, " << (sameOrder ? "same order" : "ORDER DIFFERS") << endl;
+    }
+
+    remove(bigPath.c_str());
+}
+
+void benchCurrencyParsing(const string& csvPath) {
+    // Winning Bid, CC Fee and Net Sales in the full-year export
+    const size_t MONEY_COLUMNS[] = { 4, 5, 18 };
+    const int REPEATS = 100;
+
+    csv::MappedFile file(csvPath);
+    BidSnapshot::RequireCsv(file.view(), csvPath);
+    csv::Reader reader(file.view());
+    vector<string_view> fields;
+    vector<string_view> views;
+    vector<string> strings;
+
+    reader.next(fields); // header
+    while (reader.next(fields)) {
+        for (size_t column : MONEY_COLUMNS) {
+            if (column < fields.size()) {
+                views.push_back(fields[column]);
+                strings.emplace_back(fields[column]);
+            }
+        }
+    }
+    cout << views.size() << " money fields, " << REPEATS << " passes each" << endl;
+
+    // the sinks keep the compiler from dropping the loops
+    double legacySum = 0.0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; ++r) {
+        for (const string& s : strings) {
+            legacySum += strToDouble(s, '$');
+        }
+    }
+    double legacySeconds = secondsSince(start);
+
+    double fastSum = 0.0;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; ++r) {
+        for (string_view v : views) {
+            double value;
+            parseCurrency(v, value);
+            fastSum += value;
+        }
+    }
+    double fastSeconds = secondsSince(start);
+
+    int64_t centsSum = 0;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; ++r) {
+        for (string_view v : views) {
+            int64_t cents;
+            parseCents(v, cents);
+            centsSum += cents;
+        }
+    }
+    double centsSeconds = secondsSince(start);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < views.size(); ++i) {
+        double value;
+        int64_t cents;
+        parseCurrency(views[i], value);
+        parseCents(views[i], cents);
+        if (value != strToDouble(strings[i], '$') || llround(value * 100) != cents) {
+            ++mismatches;
+        }
+    }
+
+    const double calls = double(views.size()) * REPEATS;
+    cout << "  strToDouble:   " << legacySeconds * 1e9 / calls << " ns/field" << endl;
+    cout << "  parseCurrency: " << fastSeconds * 1e9 / calls << " ns/field, speedup "
+        << legacySeconds / fastSeconds << "x" << endl;
+    cout << "  parseCents:    " << centsSeconds * 1e9 / calls << " ns/field, speedup "
+        << legacySeconds / centsSeconds << "x" << endl;
+    cout << "  fields that disagree: " << mismatches << endl;
+    cout.precision(17);
+    cout << "  one-pass total as double: " << legacySum / REPEATS
+        << ", as cents: " << formatCents(centsSum / REPEATS) << endl;
+    cout.precision(6);
+}
+
+void benchBidLayout(const string& csvPath) {
+    const size_t LARGE_COUNT = 10000000;
+
+    vector<Bid> base;
+    streamBids(csvPath, [&base](Bid&& bid) {
+        base.push_back(move(bid));
+    });
+    BidStore store;
+    loadBidStore(csvPath, store);
+    store.ShrinkToFit();
+
+    size_t bidBytes = base.size() * sizeof(Bid);
+    for (const Bid& bid : base) {
+        bidBytes += bidHeapBytes(bid);
+    }
+    cout << base.size() << " bids:" << endl;
+    cout << "  vector<Bid>: " << double(bidBytes) / base.size() << " bytes/bid (sizeof(Bid) = "
+        << sizeof(Bid) << ")" << endl;
+    cout << "  BidStore:    " << double(store.MemoryBytes()) / store.Size() << " bytes/bid, "
+        << store.FundCount() << " distinct funds" << endl;
+
+    // at scale, measure what the process actually grows by
+    cout << LARGE_COUNT << " synthetic bids:" << endl;
+    {
+        BidStore large;
+        size_t before = currentRssBytes();
+        large.Reserve(LARGE_COUNT, 0);
+        for (size_t i = 0; i < LARGE_COUNT; ++i) {
+            BidRef ref = store.At(i % store.Size());
+            large.Add(static_cast<uint32_t>(100000 + i), store.Title(ref), store.Fund(ref), store.Cents(ref));
+        }
+        large.ShrinkToFit();
+        cout << "  BidStore:    " << double(large.MemoryBytes()) / LARGE_COUNT << " bytes/bid, RSS +"
+            << double(currentRssBytes() - before) / LARGE_COUNT << " bytes/bid" << endl;
+    }
+    {
+        size_t before = currentRssBytes();
+        vector<Bid> large = syntheticBids(base, LARGE_COUNT);
+        size_t bytes = large.capacity() * sizeof(Bid);
+        for (const Bid& bid : large) {
+            bytes += bidHeapBytes(bid);
+        }
+        cout << "  vector<Bid>: " << double(bytes) / LARGE_COUNT << " bytes/bid, RSS +"
+            << double(currentRssBytes() - before) / LARGE_COUNT << " bytes/bid" << endl;
+    }
+}
+
+void benchColumnScan(const string& csvPath, size_t largeCount) {
+    BidStore store;
+    loadBidStore(csvPath, store);
+    vector<Bid> bids;
+    streamBids(csvPath, [&bids](Bid&& bid) {
+        bids.push_back(move(bid));
+    });
+
+    {
+        BidColumns columns(store);
+        cout << columns.Size() << " bids:" << endl;
+        timeColumnQuery(columns, bids, "General Fund", 10000, 1000);
+        timeColumnQuery(columns, bids, "Enterprise", 0, 1000);
+    }
+
+    // vector<Bid> plus the columns come to roughly 190 bytes a bid
+    largeCount = fitToMemory(largeCount, 190);
+    BidColumns columns(store.FundNames());
+    columns.Reserve(largeCount);
+    for (size_t i = 0; i < largeCount; ++i) {
+        BidRef ref = store.At(i % store.Size());
+        columns.Append(static_cast<uint32_t>(100000 + i), store.Title(ref), store.FundCode(ref), store.Cents(ref));
+    }
+    vector<Bid> large = syntheticBids(bids, largeCount);
+    bids.clear();
+    bids.shrink_to_fit();
+
+    cout << largeCount << " synthetic bids:" << endl;
+    timeColumnQuery(columns, large, "General Fund", 10000, 5);
+    timeColumnQuery(columns, large, "Enterprise", 0, 5);
+}
+
+void benchSortEngine(const string& csvPath) {
+    vector<Bid> base;
+    streamBids(csvPath, [&base](Bid&& bid) {
+        base.push_back(move(bid));
+    });
+
+    vector<pair<string, function<void(vector<Bid>&)>>> sorts = {
+        { "quickSort     ", [](vector<Bid>& bids) { quickSort(bids, 0, int(bids.size()) - 1); } },
+        { "std::sort     ", [](vector<Bid>& bids) {
+            sort(bids.begin(), bids.end(), [](const Bid& a, const Bid& b) { return a.title < b.title; });
+        } },
+        { "pdqSort       ", [](vector<Bid>& bids) { pdqSortBy(bids.begin(), bids.end(), BidTitleKey()); } },
+    };
+
+    cout << base.size() << " bids by title:" << endl;
+    vector<pair<string, function<void(vector<Bid>&)>>> withSelection = sorts;
+    withSelection.insert(withSelection.begin(), make_pair(string("selectionSort "),
+        function<void(vector<Bid>&)>(selectionSort)));
+    timeSorts(sortInputs(base), withSelection);
+
+    // selectionSort is O(n^2), leave it out at this size
+    const size_t LARGE_COUNT = 1000000;
+    cout << LARGE_COUNT << " synthetic bids by title:" << endl;
+    timeSorts(sortInputs(syntheticBids(base, LARGE_COUNT)), sorts);
+}
+
+void benchIndexSort(const string& csvPath, size_t largeCount) {
+    vector<Bid> base;
+    streamBids(csvPath, [&base](Bid&& bid) {
+        base.push_back(move(bid));
+    });
+    mt19937 rng(42);
+    shuffle(base.begin(), base.end(), rng);
+
+    cout << "  " << base.size() << " bids by title:" << endl;
+    timeIndexSorts(base);
+
+    // the source plus two working copies are alive at once
+    largeCount = fitToMemory(largeCount, 3 * 130);
+    vector<Bid> large = syntheticBids(base, largeCount);
+    shuffle(large.begin(), large.end(), rng);
+    cout << "  " << large.size() << " synthetic bids by title:" << endl;
+    timeIndexSorts(large);
+}
+
+void benchParallelSort(const string& csvPath, size_t largeCount) {
+    vector<Bid> base;
+    streamBids(csvPath, [&base](Bid&& bid) {
+        base.push_back(move(bid));
+    });
+
+    // input, sequential result and the working copy with its scratch buffer
+    largeCount = fitToMemory(largeCount, 4 * (sizeof(Bid) + 48));
+    vector<Bid> input = syntheticBids(base, largeCount);
+    mt19937 rng(42);
+    shuffle(input.begin(), input.end(), rng);
+
+    vector<Bid> reference = input;
+    auto start = chrono::steady_clock::now();
+    pdqSortBy(reference.begin(), reference.end(), BidTitleIdKey());
+    double sequential = secondsSince(start);
+    cout << input.size() << " synthetic bids by title and id, sequential pdqSort: " << sequential << " seconds" << endl;
+
+    vector<unsigned> threadCounts = { 1, 2, 4, 8 };
+    const unsigned allThreads = ThreadPool::DefaultThreads();
+    if (find(threadCounts.begin(), threadCounts.end(), allThreads) == threadCounts.end()) {
+        threadCounts.push_back(allThreads);
+    }
+
+    double oneThread = 0.0;
+    for (unsigned threads : threadCounts) {
+        vector<Bid> bids = input;
+        start = chrono::steady_clock::now();
+        parallelSort(bids, threads);
+        double seconds = secondsSince(start);
+        if (threads == 1) {
+            oneThread = seconds;
+        }
+
+        // whole records, so equal titles in another order count too
+        bool same = bids.size() == reference.size();
+        for (size_t i = 0; same && i < bids.size(); ++i) {
+            const Bid& a = bids[i];
+            const Bid& b = reference[i];
+            same = a.bidId == b.bidId && a.title == b.title && a.fund == b.fund && a.department == b.department
+                && a.payStatus == b.payStatus && a.amount == b.amount;
+        }
+
+        // one '#' per quarter of speedup over the 1-thread run
+        const double speedup = oneThread / seconds;
+        cout << "  " << (threads < 10 ? " " : "") << threads << " threads " << (threads == allThreads ? "(all)" : "     ")
+            << " " << seconds << " s  " << string(size_t(speedup * 4 + 0.5), '#') << " " << speedup << "x"
+            << (same ? "" : "  ORDER DIFFERS") << endl;
+    }
+}
+
+void benchBidTrees(const string& csvPath) {
+    vector<Bid> inFileOrder;
+    streamBids(csvPath, [&inFileOrder](Bid&& bid) {
+        inFileOrder.push_back(move(bid));
+    });
+
+    vector<Bid> sorted = inFileOrder;
+    sort(sorted.begin(), sorted.end(), [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; });
+    vector<Bid> shuffled = inFileOrder;
+    mt19937 rng(42);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    const vector<pair<string, const vector<Bid>*>> inputs = {
+        { "file order", &inFileOrder }, { "sorted", &sorted }, { "shuffled", &shuffled },
+    };
+    for (const auto& input : inputs) {
+        cout << "  " << input.second->size() << " bids, " << input.first << ":" << endl;
+        timeTree("BinarySearchTree", [] { return new BinarySearchTree(); }, *input.second);
+        timeTree("AvlTree         ", [] { return new AvlTree(); }, *input.second);
+    }
+}
+
+void benchBPlusTree(const string& csvPath, size_t largeCount) {
+    vector<Bid> base;
+    streamBids(csvPath, [&base](Bid&& bid) {
+        base.push_back(move(bid));
+    });
+
+    cout << "  " << base.size() << " bids from the file:" << endl;
+    compareIndexes(base, DEFAULT_SIZE);
+
+    // the source, a sorted copy and one copy in each structure; the hash
+    // table gets two buckets per key so its modulo hash never collides
+    largeCount = fitToMemory(largeCount, 4 * 130 + 2 * sizeof(Bid) + 64);
+    vector<Bid> large = syntheticBids(base, largeCount);
+    mt19937 rng(42);
+    shuffle(large.begin(), large.end(), rng);
+    cout << "  " << large.size() << " synthetic bids in random order:" << endl;
+    compareIndexes(large, unsigned(2 * large.size()));
+}
+
+void benchNodePool(const string& csvPath, int cycles) {
+    vector<Bid> bids;
+    streamBids(csvPath, [&bids](Bid&& bid) {
+        bids.push_back(move(bid));
+    });
+
+    // file order is nearly sorted and would make each search pass O(n^2)
+    mt19937 rng(42);
+    shuffle(bids.begin(), bids.end(), rng);
+    vector<string> keys;
+    for (const Bid& bid : bids) {
+        keys.push_back(bid.bidId);
+    }
+    const size_t churn = bids.size() / 10;
+
+    // per cycle: load, look up every id, remove and re-add a tenth, tear down
+    resetPeakRss();
+    const size_t rssBefore = currentRssBytes();
+    double loadSeconds = 0.0, searchSeconds = 0.0, churnSeconds = 0.0, teardownSeconds = 0.0;
+    size_t slabAllocations = 0, creates = 0, reuses = 0, found = 0;
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        BinarySearchTree* tree = new BinarySearchTree();
+        auto start = chrono::steady_clock::now();
+        for (const Bid& bid : bids) {
+            tree->Insert(bid);
+        }
+        loadSeconds += secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for (const string& key : keys) {
+            found += !tree->Search(key).bidId.empty();
+        }
+        searchSeconds += secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < churn; ++i) {
+            tree->Remove(bids[i].bidId);
+        }
+        for (size_t i = 0; i < churn; ++i) {
+            tree->Insert(bids[i]);
+        }
+        churnSeconds += secondsSince(start);
+
+        slabAllocations += tree->Nodes().SlabAllocations();
+        creates += tree->Nodes().CreateCount();
+        reuses += tree->Nodes().ReuseCount();
+        start = chrono::steady_clock::now();
+        delete tree;
+        teardownSeconds += secondsSince(start);
+    }
+    const size_t rssAfter = currentRssBytes();
+
+    cout << "  " << cycles << " cycles of " << bids.size() << " bids into a pooled BinarySearchTree:" << endl;
+    cout << "    load " << loadSeconds / cycles * 1e3 << " ms, search " << searchSeconds / cycles * 1e3
+        << " ms, remove/re-add " << churn << " " << churnSeconds / cycles * 1e3 << " ms, teardown "
+        << teardownSeconds / cycles * 1e3 << " ms per cycle"
+        << (found == keys.size() * cycles ? "" : "  LOOKUPS MISSED") << endl;
+    cout << "    " << creates << " nodes created, " << reuses << " from the freelist, " << slabAllocations
+        << " allocator calls (one per " << NodePool<Node>().SlabSize() << "-node slab)" << endl;
+    cout << "    RSS before " << rssBefore / 1024 << " KB, after " << rssAfter / 1024 << " KB, peak "
+        << peakRssBytes() / 1024 << " KB" << endl;
+
+    // the allocation pattern alone: one new/delete per node against the pool
+    double newSeconds = 0.0, poolSeconds = 0.0;
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        vector<Node*> nodes;
+        nodes.reserve(bids.size());
+        auto start = chrono::steady_clock::now();
+        for (const Bid& bid : bids) {
+            nodes.push_back(new Node(bid));
+        }
+        for (Node* node : nodes) {
+            delete node;
+        }
+        newSeconds += secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        {
+            NodePool<Node> pool;
+            for (const Bid& bid : bids) {
+                pool.Create(bid);
+            }
+        }
+        poolSeconds += secondsSince(start);
+    }
+    cout << "    allocate + free " << bids.size() << " nodes: new/delete " << newSeconds / cycles * 1e3
+        << " ms (" << 2 * bids.size() << " allocator calls), NodePool " << poolSeconds / cycles * 1e3
+        << " ms (" << 2 * ((bids.size() + NodePool<Node>().SlabSize() - 1) / NodePool<Node>().SlabSize())
+        << " allocator calls)" << endl;
+}
+
+void benchHashTables(const string& csvPath, size_t largeCount) {
+    vector<Bid> base;
+    streamBids(csvPath, [&base](Bid&& bid) {
+        base.push_back(move(bid));
+    });
+    cout << "  " << base.size() << " bids from the file:" << endl;
+    compareHashTables(base, DEFAULT_SIZE);
+    base.clear();
+
+    // ids only: the source, the lookup keys and the larger of the two tables
+    largeCount = fitToMemory(largeCount, 2 * sizeof(Bid) + sizeof(string) + 32);
+    vector<Bid> large(largeCount);
+    for (size_t i = 0; i < largeCount; ++i) {
+        large[i].bidId = to_string(100000 + i);
+    }
+    mt19937 rng(42);
+    shuffle(large.begin(), large.end(), rng);
+
+    // one bucket per id, so the modulo hash of consecutive ids never collides
+    cout << "  " << large.size() << " synthetic ids in random order:" << endl;
+    compareHashTables(large, unsigned(large.size()));
+}
+
+void benchIncrementalRehash(size_t largeCount) {
+    // the bids, the slots of both tables mid-rehash and one latency each
+    largeCount = fitToMemory(largeCount, sizeof(Bid) + 48);
+    cout << "  " << largeCount << " ids inserted one at a time, table growing from 1024 slots:" << endl;
+    timeInsertLatency("stop-the-world rehash", eREHASH_ALL_AT_ONCE, largeCount);
+    timeInsertLatency("incremental rehash (" + to_string(RobinHoodHashTable::MIGRATE_STEP) + " slots per operation)",
+                      eREHASH_INCREMENTAL, largeCount);
+}
+
+void benchConcurrentHashTable(size_t keyCount) {
+    const unsigned allThreads = ThreadPool::DefaultThreads();
+    stressConcurrentHashTable(2, 2, 20000, 20);
+    stressConcurrentHashTable(max(2u, allThreads), max(2u, allThreads), 100000, 5);
+
+    vector<unsigned> threadCounts = { 1, 2, 4, 8 };
+    if (find(threadCounts.begin(), threadCounts.end(), allThreads) == threadCounts.end()) {
+        threadCounts.push_back(allThreads);
+    }
+    const unsigned shardCounts[] = { 1, ConcurrentHashTable::DEFAULT_SHARDS };
+    const unsigned readPercents[] = { 95, 50 };
+    const size_t totalOps = 4000000;
+
+    // half of the ids present, and inserts and removes in equal numbers keep it so
+    const uint32_t keyRange = uint32_t(2 * keyCount);
+    cout << "  " << totalOps << " operations on " << keyCount << " of " << keyRange
+        << " ids, M operations/s (1 shard is a single table-wide lock):" << endl;
+    for (unsigned shards : shardCounts) {
+        ConcurrentHashTable table(shards);
+        for (uint32_t key = 0; key < keyRange; key += 2) {
+            table.Insert(stressBid(key, 0));
+        }
+        for (unsigned readPercent : readPercents) {
+            cout << "    " << shards << (shards == 1 ? " shard, " : " shards, ") << readPercent << "% reads:";
+            for (unsigned threads : threadCounts) {
+                cout << "  " << threads << (threads == 1 ? " thread " : " threads ")
+                    << mixedOpsThroughput(table, threads, readPercent, keyRange, totalOps);
+            }
+            cout << endl;
+        }
+    }
+}
+
+void benchBatchLookup(size_t largeCount) {
+    // id-only bids: the table's bids and slots, or the tree's nodes, plus the ids
+    largeCount = fitToMemory(largeCount, sizeof(Node) + sizeof(Bid) + 64);
+    vector<uint32_t> ids(largeCount);
+    for (size_t i = 0; i < largeCount; ++i) {
+        ids[i] = uint32_t(100000 + i);
+    }
+    mt19937 rng(42);
+    shuffle(ids.begin(), ids.end(), rng);
+    vector<uint32_t> queries = ids;
+    shuffle(queries.begin(), queries.end(), rng);
+
+    {
+        RobinHoodHashTable table;
+        for (uint32_t id : ids) {
+            Bid bid;
+            bid.bidId = to_string(id);
+            table.Insert(move(bid));
+        }
+        cout << "  RobinHoodHashTable, " << table.Size() << " ids, " << (table.MemoryBytes() >> 20)
+            << " MB of slots and bids, looked up in random order:" << endl;
+        timeBatchLookups(queries, [&table](uint32_t id) {
+            return !table.Search(to_string(id)).bidId.empty();
+        }, [&table](const uint32_t* keys, size_t count, const Bid** out) {
+            table.SearchBatch(keys, count, out);
+        });
+    }
+    {
+        // inserted in random order, so the tree is about 2 ln n deep
+        BinarySearchTree tree;
+        for (uint32_t id : ids) {
+            Bid bid;
+            bid.bidId = to_string(id);
+            tree.Insert(move(bid));
+        }
+        cout << "  BinarySearchTree, " << ids.size() << " ids, " << (tree.Nodes().MemoryBytes() >> 20)
+            << " MB of nodes, average depth " << tree.AverageDepth() << ":" << endl;
+        timeBatchLookups(queries, [&tree](uint32_t id) {
+            return !tree.Search(to_string(id)).bidId.empty();
+        }, [&tree](const uint32_t* keys, size_t count, const Bid** out) {
+            tree.SearchBatch(keys, count, out);
+        });
+    }
+}
+
+void benchSnapshot(const string& csvPath, size_t largeBytes) {
+    const bool canDropCache = dropFileCache(csvPath.c_str());
+    if (!canDropCache) {
+        cout << "  (files can't be dropped from the page cache here, so only warm times are shown)" << endl;
+    }
+
+    const string paths[] = { csvPath, replicateCsv(csvPath, largeBytes) };
+    for (const string& path : paths) {
+        vector<Bid> parsed;
+        streamBids(path, [&parsed](Bid&& bid) {
+            parsed.push_back(move(bid));
+        });
+        vector<uint32_t> lookupIds;
+        for (size_t i = 0; i < parsed.size() && lookupIds.size() < 1000; i += parsed.size() / 1000 + 1) {
+            uint32_t key;
+            if (bidIdToKey(parsed[i].bidId, key)) {
+                lookupIds.push_back(key);
+            }
+        }
+
+        const string snapshotPath = (filesystem::temp_directory_path()
+            / (filesystem::path(path).stem().string() + ".bidsnap")).string();
+        auto start = chrono::steady_clock::now();
+        BidSnapshot::Write(snapshotPath, parsed);
+        const double writeSeconds = secondsSince(start);
+
+        bool same;
+        size_t snapshotBytes;
+        {
+            BidSnapshot snapshot(snapshotPath);
+            snapshotBytes = snapshot.FileBytes();
+            same = snapshot.Size() == parsed.size();
+            for (size_t i = 0; same && i < parsed.size(); ++i) {
+                same = snapshot.BidId(i) == parsed[i].bidId && snapshot.Title(i) == parsed[i].title
+                    && snapshot.Fund(i) == parsed[i].fund && snapshot.Department(i) == parsed[i].department
+                    && snapshot.PayStatus(i) == parsed[i].payStatus && snapshot.Amount(i) == parsed[i].amount;
+            }
+        }
+        cout << "  " << filesystem::path(path).filename().string() << ": " << parsed.size() << " bids, "
+            << (filesystem::file_size(path) >> 20) << " MB of CSV; " << (snapshotBytes >> 20)
+            << " MB snapshot written in " << writeSeconds << " s" << (same ? "" : ", SNAPSHOT DIFFERS") << endl;
+        parsed = vector<Bid>();
+
+        // cold: the file is dropped from the page cache first; warm: straight after
+        auto timeStep = [canDropCache](const string& name, const string& file, function<size_t()> step) {
+            cout << "    " << name << ": ";
+            if (canDropCache) {
+                dropFileCache(file.c_str());
+                auto start = chrono::steady_clock::now();
+                step();
+                cout << "cold " << secondsSince(start) << " s, ";
+            }
+            auto start = chrono::steady_clock::now();
+            size_t result = step();
+            cout << "warm " << secondsSince(start) << " s (" << result << ")" << endl;
+        };
+        timeStep("parse CSV into bids", path, [&path]() {
+            vector<Bid> bids;
+            streamBids(path, [&bids](Bid&& bid) {
+                bids.push_back(move(bid));
+            });
+            return bids.size();
+        });
+        timeStep("snapshot into bids, checksum verified", snapshotPath, [&snapshotPath]() {
+            return BidSnapshot(snapshotPath).ToBids().size();
+        });
+        timeStep("snapshot opened, checksum verified", snapshotPath, [&snapshotPath]() {
+            return BidSnapshot(snapshotPath).Size();
+        });
+        timeStep("snapshot opened unverified, 1000 ids found by its index", snapshotPath,
+                 [&snapshotPath, &lookupIds]() {
+            BidSnapshot snapshot(snapshotPath, false);
+            size_t found = 0;
+            for (uint32_t id : lookupIds) {
+                found += snapshot.Find(id) != BidSnapshot::NOT_FOUND;
+            }
+            return found;
+        });
+        remove(snapshotPath.c_str());
+    }
+    remove(paths[1].c_str());
+}
+
+void benchGeneratedPipeline(const string& csvPath, size_t rows) {
+    // a copy of each bid in the hash table and one in the tree, strings and nodes included
+    rows = fitToMemory(rows, 2 * (sizeof(Bid) + 96));
+    const size_t CHUNK_ROWS = 1 << 16;
+    const BidGenerator::IdOrder orders[] = { BidGenerator::eIDS_SORTED, BidGenerator::eIDS_SHUFFLED,
+                                             BidGenerator::eIDS_ZIPF, BidGenerator::eIDS_DUPLICATES };
+
+    cout << "  " << rows << " generated bids per id order, in chunks of " << CHUNK_ROWS
+        << " rows that never touch disk:" << endl;
+    for (BidGenerator::IdOrder order : orders) {
+        BidGenerator::Config config;
+        config.rows = rows;
+        config.order = order;
+        BidGenerator generator(csvPath, config);
+        RobinHoodHashTable table;
+        AvlTree tree;
+        double generateSeconds = 0, parseSeconds = 0, tableSeconds = 0, treeSeconds = 0;
+        size_t textBytes = 0;
+        string text;
+        vector<Bid> chunk;
+
+        for (;;) {
+            auto start = chrono::steady_clock::now();
+            if (generator.NextChunk(text, CHUNK_ROWS) == 0) {
+                break;
+            }
+            generateSeconds += secondsSince(start);
+            textBytes += text.size();
+
+            chunk.clear();
+            start = chrono::steady_clock::now();
+            streamCsvBids(text, "generated chunk", [&chunk](Bid&& bid) {
+                chunk.push_back(move(bid));
+            });
+            parseSeconds += secondsSince(start);
+
+            start = chrono::steady_clock::now();
+            for (const Bid& bid : chunk) {
+                table.Insert(bid);
+            }
+            tableSeconds += secondsSince(start);
+
+            start = chrono::steady_clock::now();
+            for (Bid& bid : chunk) {
+                tree.Insert(move(bid));
+            }
+            treeSeconds += secondsSince(start);
+        }
+        cout << "  " << setw(10) << BidGenerator::OrderName(order) << ": " << table.Size() << " distinct ids; generate "
+            << (textBytes >> 20) / generateSeconds << " MB/s, parse " << rows / parseSeconds / 1e6
+            << " M bids/s, RobinHoodHashTable insert " << tableSeconds << " s, AvlTree insert "
+            << treeSeconds << " s (height " << tree.Height() << ")" << endl;
+    }
+}
+
+void benchLatencyProbes(size_t keyCount) {
+    keyCount = fitToMemory(keyCount, 2 * (sizeof(Bid) + 64));
+    vector<uint32_t> ids(keyCount);
+    for (size_t i = 0; i < keyCount; ++i) {
+        ids[i] = uint32_t(100000 + i);
+    }
+    mt19937 rng(42);
+    shuffle(ids.begin(), ids.end(), rng);
+
+    const bool wasRecording = latencyRecording();
+    setLatencyRecording(false);
+    RobinHoodHashTable table;
+    AvlTree tree;
+    for (uint32_t id : ids) {
+        Bid bid;
+        bid.bidId = to_string(id);
+        table.Insert(bid);
+        tree.Insert(move(bid));
+    }
+    vector<string> queries;
+    for (uint32_t id : ids) {
+        queries.push_back(to_string(id));
+    }
+    shuffle(queries.begin(), queries.end(), rng);
+
+    // the same searches with the probes idle and recording
+    cout << "  " << keyCount << " ids, every one searched in random order:" << endl;
+    auto timeSearches = [&queries](const char* name, function<bool(const string&)> search) {
+        for (bool on : { false, true }) {
+            setLatencyRecording(on);
+            size_t found = 0;
+            auto start = chrono::steady_clock::now();
+            for (const string& query : queries) {
+                found += search(query);
+            }
+            const double seconds = secondsSince(start);
+            setLatencyRecording(false);
+            cout << "    " << setw(18) << name << ", recording " << (on ? "on: " : "off:") << " "
+                << seconds * 1e9 / queries.size() << " ns per search (" << found << " found)" << endl;
+        }
+    };
+    resetLatencyStats();
+    timeSearches("RobinHoodHashTable", [&table](const string& query) {
+        return !table.Search(query).bidId.empty();
+    });
+    timeSearches("AvlTree", [&tree](const string& query) {
+        return !tree.Search(query).bidId.empty();
+    });
+    printLatencyStats(cout);
+
+    // leave the menu's own figures out of it
+    resetLatencyStats();
+    setLatencyRecording(wasRecording);
+}
+
+void benchSecondaryIndexes(const string& csvPath, size_t largeCount) {
+    IndexedBidTable table;
+    auto start = chrono::steady_clock::now();
+    streamBids(csvPath, [&table](Bid&& bid) {
+        table.Insert(move(bid));
+    });
+    cout << "  " << csvPath << ", " << table.Size() << " bids indexed in " << secondsSince(start) << " s:" << endl;
+    compareIndexQueries(table);
+    table.Clear();
+
+    // the bid and its strings, an id map entry and two index entries
+    largeCount = fitToMemory(largeCount, sizeof(Bid) + 96 + 32 + 2 * 4);
+    const size_t CHUNK_ROWS = 1 << 16;
+    BidGenerator::Config config;
+    config.rows = largeCount;
+    config.order = BidGenerator::eIDS_SHUFFLED;
+    BidGenerator generator(csvPath, config);
+    string text;
+    double insertSeconds = 0;
+    while (generator.NextChunk(text, CHUNK_ROWS) != 0) {
+        vector<Bid> chunk;
+        streamCsvBids(text, "generated chunk", [&chunk](Bid&& bid) {
+            chunk.push_back(move(bid));
+        });
+        start = chrono::steady_clock::now();
+        for (Bid& bid : chunk) {
+            table.Insert(move(bid));
+        }
+        insertSeconds += secondsSince(start);
+    }
+    cout << "  " << table.Size() << " generated bids indexed at " << table.Size() / insertSeconds / 1e6
+        << " M inserts/s:" << endl;
+    compareIndexQueries(table);
+
+    // keeping the indexes consistent: take out a random tenth and put it back
+    vector<Bid> removed;
+    mt19937 rng(7);
+    uniform_int_distribution<uint32_t> pick(0, uint32_t(config.firstId + largeCount * config.idStride));
+    const size_t removeCount = table.Size() / 10;
+    start = chrono::steady_clock::now();
+    while (removed.size() < removeCount) {
+        const string id = to_string(pick(rng));
+        const Bid* bid = table.Find(id);
+        if (bid != nullptr) {
+            removed.push_back(*bid);
+            table.Remove(id);
+        }
+    }
+    const double removeSeconds = secondsSince(start);
+    cout << "  after removing " << removeCount << " of them (" << removeCount / removeSeconds / 1e6
+        << " M removes/s):" << endl;
+    compareIndexQueries(table);
+    for (Bid& bid : removed) {
+        table.Insert(move(bid));
+    }
+}
+
+void benchBitmapFilters(const string& csvPath, size_t largeCount) {
+    vector<Bid> bids;
+    streamBids(csvPath, [&bids](Bid&& bid) {
+        bids.push_back(move(bid));
+    });
+    cout << "  " << csvPath << ", " << bids.size() << " bids:" << endl;
+    compareBitmapFilters(bids);
+
+    // the bid and its strings, and a bit or two of bitmap per column
+    largeCount = fitToMemory(largeCount, sizeof(Bid) + 96);
+    BidGenerator::Config config;
+    config.rows = largeCount;
+    config.order = BidGenerator::eIDS_SHUFFLED;
+    BidGenerator generator(csvPath, config);
+    bids.clear();
+    bids.shrink_to_fit();
+    bids.reserve(largeCount);
+    string text;
+    while (generator.NextChunk(text, 1 << 16) != 0) {
+        streamCsvBids(text, "generated chunk", [&bids](Bid&& bid) {
+            bids.push_back(move(bid));
+        });
+    }
+    cout << "  " << bids.size() << " generated bids:" << endl;
+    compareBitmapFilters(bids);
+}
+
+void benchAggregation(const string& csvPath, size_t largeCount) {
+    SalesColumns columns;
+    loadSalesColumns(csvPath, columns);
+    cout << "  " << csvPath << ", " << columns.Size() << " bids:" << endl;
+    compareAggregation(columns);
+
+    // three amounts and three keys a row
+    const size_t rowBytes = eMEASURES * sizeof(int64_t) + eGROUPS * sizeof(uint16_t);
+    for (size_t rows : { size_t(10000000), largeCount }) {
+        rows = fitToMemory(rows, rowBytes);
+        const SalesColumns sample = columns.Resample(rows, 2016);
+        cout << "  " << sample.Size() << " resampled bids, " << sample.MemoryBytes() / max<size_t>(rows, 1) << " bytes/bid:" << endl;
+        compareAggregation(sample);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef     _BENCHMARKS_HPP_
+# define    _BENCHMARKS_HPP_
+
+# include <cstddef>
+# include <string>
+
+/**
+ * Benchmarks reachable from the "Benchmarks" menu in main(). Each one
+ * prints its own report to std::cout.
+ */
+
+// check every CSV tokenizer mode against csv::Parser row for row
+bool verifyTokenizer(const std::string& csvPath);
+
+// tokenizer throughput in MB/s over csvPath replicated to targetBytes
+void benchTokenizer(const std::string& csvPath, std::size_t targetBytes);
+
+// parallel loader wall time from 1 to every hardware thread
+void benchParallelLoad(const std::string& csvPath, std::size_t targetBytes);
+
+// strToDouble against parseCurrency / parseCents on every money column
+void benchCurrencyParsing(const std::string& csvPath);
+
+// bytes per bid of vector<Bid> against BidStore at 17k and 10M bids
+void benchBidLayout(const std::string& csvPath);
+
+// filter/aggregate over BidColumns (scalar and AVX2) against vector<Bid>
+void benchColumnScan(const std::string& csvPath, std::size_t largeCount);
+
+// pdqSort against quickSort, selectionSort and std::sort on several input orders
+void benchSortEngine(const std::string& csvPath);
+
+// title sort through a permutation against moving whole records
+void benchIndexSort(const std::string& csvPath, std::size_t largeCount);
+
+// strong scaling of parallelSort for 1, 2, 4, 8 and all threads
+void benchParallelSort(const std::string& csvPath, std::size_t largeCount);
+
+// unbalanced BinarySearchTree against AvlTree on file, sorted and shuffled order
+void benchBidTrees(const std::string& csvPath);
+
+// BPlusTree against HashTable and BinarySearchTree: memory per key and lookups/s
+void benchBPlusTree(const std::string& csvPath, std::size_t largeCount);
+
+// load/search/reload cycles of a pooled BinarySearchTree, allocator calls and RSS
+void benchNodePool(const std::string& csvPath, int cycles);
+
+// chained HashTable against RobinHoodHashTable: throughput and probe lengths
+void benchHashTables(const std::string& csvPath, std::size_t largeCount);
+
+// insert latency percentiles of RobinHoodHashTable, incremental against stop-the-world rehash
+void benchIncrementalRehash(std::size_t largeCount);
+
+// ConcurrentHashTable stress check, then 95/5 and 50/50 read/write throughput by thread count
+void benchConcurrentHashTable(std::size_t keyCount);
+
+// SearchBatch with prefetching against one lookup at a time, on tables far larger than the cache
+void benchBatchLookup(std::size_t largeCount);
+
+// BidSnapshot write, then cold and warm load time against parsing the CSV, at file size and largeBytes
+void benchSnapshot(const std::string& csvPath, std::size_t largeBytes);
+
+// BidGenerator chunks parsed from memory into RobinHoodHashTable and AvlTree, for each id order
+void benchGeneratedPipeline(const std::string& csvPath, std::size_t rows);
+
+// Search cost with latency recording off and on, then the percentiles it recorded
+void benchLatencyProbes(std::size_t keyCount);
+
+// IndexedBidTable fund, amount and title queries against full scans, before and after removes
+void benchSecondaryIndexes(const std::string& csvPath, std::size_t largeCount);
+
+// BidBitmapIndex filters against scanning vector<Bid>: latency, and index memory per bid
+void benchBitmapFilters(const std::string& csvPath, std::size_t largeCount);
+
+// COUNT/SUM/MIN/MAX of the sales columns by fund, department and month: hash aggregation against std::map
+void benchAggregation(const std::string& csvPath, std::size_t largeCount);
+
+#endif /*!_BENCHMARKS_HPP_*/
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include "Bid.hpp"
+#include "CSVreader.hpp"
+#include "Currency.hpp"
+using namespace std;
+
+void displayBid(const Bid& bid) {
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+        << bid.fund << endl;
+    return;
+}
+
+BidLayout bidLayoutFromHeader(const vector<string_view>& header) {
+    BidLayout layout;
+    for (size_t i = 0; i < header.size(); ++i) {
+        // header cells come with stray blanks, e.g. "Auction Title "
+        string_view name = header[i];
+        while (!name.empty() && (name.back() == ' ' || name.back() == '\r')) {
+            name.remove_suffix(1);
+        }
+        if (name == "Fund") {
+            layout.fund = i;
+        }
+        else if (name == "Department") {
+            layout.department = i;
+        }
+        else if (name == "Pay Status") {
+            layout.payStatus = i;
+        }
+    }
+    return layout;
+}
+
+Bid bidFromFields(const vector<string_view>& fields, const BidLayout& layout) {
+    Bid bid;
+    bid.bidId = csv::unquote(fields[layout.bidId]);
+    bid.title = csv::unquote(fields[layout.title]);
+    bid.fund = csv::unquote(fields[layout.fund]);
+    if (layout.department < fields.size()) {
+        bid.department = csv::unquote(fields[layout.department]);
+    }
+    if (layout.payStatus < fields.size()) {
+        bid.payStatus = csv::unquote(fields[layout.payStatus]);
+    }
+    parseCurrency(fields[layout.amount], bid.amount);
+    return bid;
+}
+
+bool bidIdToKey(string_view bidId, uint32_t& key) {
+    const char* end = bidId.data() + bidId.size();
+    auto result = from_chars(bidId.data(), end, key);
+    return !bidId.empty() && result.ec == errc() && result.ptr == end;
+}
+
+/**
+ * Simple C function to convert a string to a double
+ * after stripping out unwanted char
+ *
+ * credit: http://stackoverflow.com/a/24875936
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
@@ -0,0 +1,80 @@
+#ifndef     _BID_HPP_
+# define    _BID_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <vector>
+
+// define a structure to hold bid information
+struct Bid {
+    std::string bidId; // unique identifier
+    std::string title;
+    std::string fund;
+    std::string department;
+    std::string payStatus;
+    double amount;
+    Bid() {
+        amount = 0.0;
+    }
+};
+
+/**
+ * Display the bid information to the console (std::out)
+ *
+ * @param bid struct containing the bid info
+ */
+void displayBid(const Bid& bid);
+
+/**
+ * Positions of the columns a Bid keeps. The defaults fit the December
+ * export; the full-year export has Fund in column 19 instead of 8, and
+ * a Pay Status in column 9 that the December export doesn't have.
+ */
+struct BidLayout {
+    static const std::size_t NO_COLUMN = std::size_t(-1);
+
+    std::size_t title = 0;
+    std::size_t bidId = 1;
+    std::size_t department = 2;
+    std::size_t amount = 4;
+    std::size_t fund = 8;
+    std::size_t payStatus = NO_COLUMN;
+};
+
+/**
+ * Work out the column positions from a header record
+ *
+ * @param header raw field views of the header
+ * @return the layout, defaults for any column not found
+ */
+BidLayout bidLayoutFromHeader(const std::vector<std::string_view>& header);
+
+/**
+ * Build a bid from the raw fields of one CSV record, materializing
+ * only the four columns a Bid keeps
+ *
+ * @param fields raw field views of the record
+ * @param layout where the columns are
+ * @return the bid
+ */
+Bid bidFromFields(const std::vector<std::string_view>& fields, const BidLayout& layout = BidLayout());
+
+/**
+ * Read a bid id as an unsigned 32-bit number
+ *
+ * @param bidId the id, digits only
+ * @param key set to the number on success
+ * @return false if the id is empty, has a non-digit or is too large
+ */
+bool bidIdToKey(std::string_view bidId, std::uint32_t& key);
+
+/**
+ * Convert a string to a double after stripping out an unwanted char
+ *
+ * @param ch The character to strip out
+ */
+double strToDouble(std::string str, char ch);
+
+#endif /*!_BID_HPP_*/
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include "BidBitmapIndex.hpp"
+using namespace std;
+
+/**
+ * Constructor
+ */
+BidBitmapIndex::BidBitmapIndex() {
+}
+
+BidBitmapIndex::BidBitmapIndex(const vector<Bid>& bids) {
+    for (size_t i = 0; i < bids.size(); ++i) {
+        Add(uint32_t(i), bids[i]);
+    }
+}
+
+/**
+ * Destructor
+ */
+BidBitmapIndex::~BidBitmapIndex() {
+}
+
+void BidBitmapIndex::Add(uint32_t row, const Bid& bid) {
+    for (int c = 0; c < eFILTER_COLUMNS; ++c) {
+        byValue[c][filterValue(bid, FilterColumn(c))].Add(row);
+    }
+    rows.Add(row);
+}
+
+void BidBitmapIndex::Remove(uint32_t row, const Bid& bid) {
+    for (int c = 0; c < eFILTER_COLUMNS; ++c) {
+        unordered_map<string, RoaringBitmap>::iterator found = byValue[c].find(filterValue(bid, FilterColumn(c)));
+        if (found != byValue[c].end() && found->second.Remove(row) && found->second.Empty()) {
+            byValue[c].erase(found);
+        }
+    }
+    rows.Remove(row);
+}
+
+void BidBitmapIndex::Clear() {
+    for (unordered_map<string, RoaringBitmap>& values : byValue) {
+        values.clear();
+    }
+    rows.Clear();
+}
+
+/**
+ * The bitmap for a filter: an index bitmap itself for a single test, or
+ * scratch holding a combination. An AND with a NOT on either side becomes
+ * AndNot of the other side; any other NOT, including one under an OR, is
+ * taken against every row.
+ */
+const RoaringBitmap& BidBitmapIndex::evaluate(const BidFilter& filter, RoaringBitmap& scratch) const {
+    switch (filter.Kind()) {
+    case eFILTER_EQUALS: {
+        unordered_map<string, RoaringBitmap>::const_iterator found = byValue[filter.Column()].find(filter.Value());
+        if (found == byValue[filter.Column()].end()) {
+            scratch.Clear();
+            return scratch;
+        }
+        return found->second;
+    }
+    case eFILTER_AND: {
+        RoaringBitmap left, right;
+        const BidFilter a = filter.Left(), b = filter.Right();
+        if (b.Kind() == eFILTER_NOT) {
+            scratch = evaluate(a, left).AndNot(evaluate(b.Left(), right));
+        }
+        else if (a.Kind() == eFILTER_NOT) {
+            scratch = evaluate(b, right).AndNot(evaluate(a.Left(), left));
+        }
+        else {
+            scratch = evaluate(a, left).And(evaluate(b, right));
+        }
+        return scratch;
+    }
+    case eFILTER_OR: {
+        RoaringBitmap left, right;
+        scratch = evaluate(filter.Left(), left).Or(evaluate(filter.Right(), right));
+        return scratch;
+    }
+    case eFILTER_NOT: {
+        RoaringBitmap operand;
+        scratch = rows.AndNot(evaluate(filter.Left(), operand));
+        return scratch;
+    }
+    default:
+        return rows;
+    }
+}
+
+RoaringBitmap BidBitmapIndex::Rows(const BidFilter& filter) const {
+    RoaringBitmap scratch;
+    const RoaringBitmap& result = evaluate(filter, scratch);
+    return &result == &scratch ? scratch : result;
+}
+
+vector<pair<string, size_t>> BidBitmapIndex::Values(FilterColumn column) const {
+    vector<pair<string, size_t>> values;
+    for (const pair<const string, RoaringBitmap>& value : byValue[column]) {
+        values.emplace_back(value.first, value.second.Cardinality());
+    }
+    sort(values.begin(), values.end(), [](const pair<string, size_t>& a, const pair<string, size_t>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return values;
+}
+
+size_t BidBitmapIndex::MemoryBytes() const {
+    size_t bytes = sizeof(*this) + rows.MemoryBytes() - sizeof(rows);
+    for (const unordered_map<string, RoaringBitmap>& values : byValue) {
+        // a node per value and its bucket slot
+        bytes += values.bucket_count() * sizeof(void*);
+        for (const pair<const string, RoaringBitmap>& value : values) {
+            bytes += sizeof(value) + 2 * sizeof(void*) + value.first.capacity() + 1
+                + value.second.MemoryBytes() - sizeof(value.second);
+        }
+    }
+    return bytes;
+}
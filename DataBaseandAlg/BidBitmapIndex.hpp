@@ -0,0 +1,50 @@
+#ifndef     _BIDBITMAPINDEX_HPP_
+# define    _BIDBITMAPINDEX_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <unordered_map>
+# include <utility>
+# include <vector>
+# include "Bid.hpp"
+# include "BidFilter.hpp"
+# include "RoaringBitmap.hpp"
+
+/**
+ * A RoaringBitmap of row numbers for every fund, department and pay
+ * status value, and one of every row, so a BidFilter is answered with
+ * bitmap operations and only the matching bids are touched. A row is
+ * whatever number the owner gives a bid: its position in a vector, or a
+ * record number in IndexedBidTable.
+ */
+class BidBitmapIndex {
+
+private:
+    std::unordered_map<std::string, RoaringBitmap> byValue[eFILTER_COLUMNS];
+    RoaringBitmap rows;
+
+    const RoaringBitmap& evaluate(const BidFilter& filter, RoaringBitmap& scratch) const;
+
+public:
+    BidBitmapIndex();
+    // rows numbered by position in bids
+    explicit BidBitmapIndex(const std::vector<Bid>& bids);
+    virtual ~BidBitmapIndex();
+
+    void Add(std::uint32_t row, const Bid& bid);
+    // bid has to be the one the row was added with
+    void Remove(std::uint32_t row, const Bid& bid);
+    void Clear();
+
+    // the rows whose bid the filter matches
+    RoaringBitmap Rows(const BidFilter& filter) const;
+
+    // each value of the column with its number of rows, most rows first
+    std::vector<std::pair<std::string, std::size_t>> Values(FilterColumn column) const;
+
+    std::size_t Size() const { return rows.Cardinality(); }
+    std::size_t MemoryBytes() const;
+};
+
+#endif /*!_BIDBITMAPINDEX_HPP_*/
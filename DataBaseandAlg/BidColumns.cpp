@@ -0,0 +1,189 @@
+#include <algorithm>
+#include "BidColumns.hpp"
+#include "CpuFeatures.hpp"
+
+namespace {
+
+inline bool resolveAvx2(KernelMode mode) {
+    return mode != eKERNEL_SCALAR && cpuHasAvx2();
+}
+
+void summarizeScalar(const std::int64_t* cents, const std::uint16_t* funds, std::size_t begin, std::size_t end,
+                     int fundCode, std::int64_t aboveCents, AmountSummary& res) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (cents[i] > aboveCents && (fundCode < 0 || funds[i] == fundCode)) {
+            ++res.count;
+            res.sum += cents[i];
+            res.min = std::min(res.min, cents[i]);
+            res.max = std::max(res.max, cents[i]);
+        }
+    }
+}
+
+void filterScalar(const std::int64_t* cents, const std::uint16_t* funds, std::size_t begin, std::size_t end,
+                  int fundCode, std::int64_t aboveCents, std::vector<std::uint32_t>& rows) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (cents[i] > aboveCents && (fundCode < 0 || funds[i] == fundCode)) {
+            rows.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+#ifdef HAVE_X86
+/**
+ * Lane mask (all ones / all zeros per 64-bit lane) for 4 rows starting at i
+ */
+TARGET_AVX2 inline __m256i matchMask(const std::int64_t* cents, const std::uint16_t* funds, std::size_t i,
+                                     __m256i fundV, __m256i aboveV, bool anyFund, __m256i& values) {
+    values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cents + i));
+    __m256i m = _mm256_cmpgt_epi64(values, aboveV);
+    if (!anyFund) {
+        // 4 uint16 codes widened to 4 int64 lanes
+        __m256i f = _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(funds + i)));
+        m = _mm256_and_si256(m, _mm256_cmpeq_epi64(f, fundV));
+    }
+    return m;
+}
+
+TARGET_AVX2 std::size_t summarizeAvx2(const std::int64_t* cents, const std::uint16_t* funds, std::size_t n,
+                                      int fundCode, std::int64_t aboveCents, AmountSummary& res) {
+    const __m256i fundV = _mm256_set1_epi64x(fundCode);
+    const __m256i aboveV = _mm256_set1_epi64x(aboveCents);
+    const bool anyFund = fundCode < 0;
+    __m256i sum = _mm256_setzero_si256();
+    __m256i count = _mm256_setzero_si256();
+    __m256i minV = _mm256_set1_epi64x(res.min);
+    __m256i maxV = _mm256_set1_epi64x(res.max);
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i v;
+        const __m256i m = matchMask(cents, funds, i, fundV, aboveV, anyFund, v);
+        sum = _mm256_add_epi64(sum, _mm256_and_si256(v, m));
+        count = _mm256_sub_epi64(count, m);
+        // AVX2 has no 64-bit min/max; blend where the row matches and wins
+        minV = _mm256_blendv_epi8(minV, v, _mm256_and_si256(m, _mm256_cmpgt_epi64(minV, v)));
+        maxV = _mm256_blendv_epi8(maxV, v, _mm256_and_si256(m, _mm256_cmpgt_epi64(v, maxV)));
+    }
+
+    alignas(32) std::int64_t lanes[4][4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), sum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), count);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), minV);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[3]), maxV);
+    for (int k = 0; k < 4; ++k) {
+        res.sum += lanes[0][k];
+        res.count += static_cast<std::size_t>(lanes[1][k]);
+        res.min = std::min(res.min, lanes[2][k]);
+        res.max = std::max(res.max, lanes[3][k]);
+    }
+    return i;
+}
+
+TARGET_AVX2 std::size_t filterAvx2(const std::int64_t* cents, const std::uint16_t* funds, std::size_t n,
+                                   int fundCode, std::int64_t aboveCents, std::vector<std::uint32_t>& rows) {
+    const __m256i fundV = _mm256_set1_epi64x(fundCode);
+    const __m256i aboveV = _mm256_set1_epi64x(aboveCents);
+    const bool anyFund = fundCode < 0;
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i v;
+        const __m256i m = matchMask(cents, funds, i, fundV, aboveV, anyFund, v);
+        const int bits = _mm256_movemask_pd(_mm256_castsi256_pd(m));
+        if (bits == 0) {
+            continue;
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            if (bits & (1 << lane)) {
+                rows.push_back(static_cast<std::uint32_t>(i + lane));
+            }
+        }
+    }
+    return i;
+}
+#endif
+
+}
+
+BidColumns::BidColumns(std::vector<std::string> funds) : fundNames(std::move(funds)) {
+    titleOffsets.push_back(0);
+}
+
+/**
+ * Copy every bid of a store into columns, keeping its fund codes
+ */
+BidColumns::BidColumns(const BidStore& store) : fundNames(store.FundNames()) {
+    titleOffsets.push_back(0);
+    Reserve(store.Size());
+    for (std::size_t i = 0; i < store.Size(); ++i) {
+        BidRef ref = store.At(i);
+        Append(store.BidId(ref), store.Title(ref), store.FundCode(ref), store.Cents(ref));
+    }
+}
+
+void BidColumns::Append(std::uint32_t bidId, std::string_view title, std::uint16_t fundCode, std::int64_t amountCents) {
+    bidIds.push_back(bidId);
+    cents.push_back(amountCents);
+    fundCodes.push_back(fundCode);
+    titles.append(title.data(), title.size());
+    titleOffsets.push_back(titles.size());
+}
+
+void BidColumns::Reserve(std::size_t bids) {
+    bidIds.reserve(bids);
+    cents.reserve(bids);
+    fundCodes.reserve(bids);
+    titleOffsets.reserve(bids + 1);
+}
+
+int BidColumns::FindFund(std::string_view name) const {
+    for (std::size_t code = 0; code < fundNames.size(); ++code) {
+        if (fundNames[code] == name) {
+            return static_cast<int>(code);
+        }
+    }
+    return ANY_FUND - 1;
+}
+
+AmountSummary BidColumns::Summarize(int fundCode, std::int64_t aboveCents, KernelMode mode) const {
+    AmountSummary res;
+    std::size_t done = 0;
+    if (fundCode < ANY_FUND) {
+        return res;
+    }
+#ifdef HAVE_X86
+    if (resolveAvx2(mode)) {
+        done = summarizeAvx2(cents.data(), fundCodes.data(), Size(), fundCode, aboveCents, res);
+    }
+#endif
+    summarizeScalar(cents.data(), fundCodes.data(), done, Size(), fundCode, aboveCents, res);
+    return res;
+}
+
+std::vector<std::uint32_t> BidColumns::Filter(int fundCode, std::int64_t aboveCents, KernelMode mode) const {
+    std::vector<std::uint32_t> rows;
+    std::size_t done = 0;
+    if (fundCode < ANY_FUND) {
+        return rows;
+    }
+#ifdef HAVE_X86
+    if (resolveAvx2(mode)) {
+        done = filterAvx2(cents.data(), fundCodes.data(), Size(), fundCode, aboveCents, rows);
+    }
+#endif
+    filterScalar(cents.data(), fundCodes.data(), done, Size(), fundCode, aboveCents, rows);
+    return rows;
+}
+
+std::size_t BidColumns::MemoryBytes() const {
+    std::size_t bytes = bidIds.capacity() * sizeof(std::uint32_t)
+        + cents.capacity() * sizeof(std::int64_t)
+        + fundCodes.capacity() * sizeof(std::uint16_t)
+        + titleOffsets.capacity() * sizeof(std::uint64_t)
+        + titles.capacity();
+    for (const std::string& name : fundNames) {
+        bytes += sizeof(std::string) + name.capacity();
+    }
+    return bytes;
+}
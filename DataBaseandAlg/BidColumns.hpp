@@ -0,0 +1,89 @@
+#ifndef     _BIDCOLUMNS_HPP_
+# define    _BIDCOLUMNS_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <limits>
+# include <string>
+# include <string_view>
+# include <vector>
+# include "BidStore.hpp"
+
+/**
+ * Which implementation a column kernel runs. eKERNEL_AUTO uses AVX2
+ * when the CPU has it.
+ */
+enum KernelMode {
+    eKERNEL_AUTO = 0,
+    eKERNEL_SCALAR = 1,
+    eKERNEL_AVX2 = 2
+};
+
+/**
+ * Result of an aggregate over the amount column, in cents.
+ * min and max keep their start values when count is 0.
+ */
+struct AmountSummary {
+    std::size_t count = 0;
+    std::int64_t sum = 0;
+    std::int64_t min = std::numeric_limits<std::int64_t>::max();
+    std::int64_t max = std::numeric_limits<std::int64_t>::min();
+};
+
+/**
+ * Structure-of-arrays copy of a bid set: one array per field, so a scan
+ * over amounts and funds only touches those two arrays. Titles live in
+ * one arena addressed through an offsets array (Size() + 1 entries).
+ */
+class BidColumns {
+
+private:
+    std::vector<std::uint32_t> bidIds;
+    std::vector<std::int64_t> cents;
+    std::vector<std::uint16_t> fundCodes;
+    std::vector<std::uint64_t> titleOffsets;
+    std::string titles;
+    std::vector<std::string> fundNames;
+
+public:
+    // pass as fundCode to match every fund
+    static const int ANY_FUND = -1;
+
+    explicit BidColumns(std::vector<std::string> funds = std::vector<std::string>());
+    explicit BidColumns(const BidStore& store);
+
+    void Append(std::uint32_t bidId, std::string_view title, std::uint16_t fundCode, std::int64_t amountCents);
+    void Reserve(std::size_t bids);
+
+    std::size_t Size() const { return bidIds.size(); }
+    std::uint32_t BidId(std::size_t i) const { return bidIds[i]; }
+    std::int64_t Cents(std::size_t i) const { return cents[i]; }
+    std::uint16_t FundCode(std::size_t i) const { return fundCodes[i]; }
+    std::string_view Title(std::size_t i) const {
+        return std::string_view(titles.data() + titleOffsets[i], titleOffsets[i + 1] - titleOffsets[i]);
+    }
+
+    std::size_t FundCount() const { return fundNames.size(); }
+    const std::string& FundName(std::uint16_t code) const { return fundNames[code]; }
+    // code of a fund name, or ANY_FUND - 1 when it isn't in the dictionary
+    int FindFund(std::string_view name) const;
+
+    // raw column access for kernels that live elsewhere
+    const std::uint32_t* BidIdData() const { return bidIds.data(); }
+    const std::int64_t* CentsData() const { return cents.data(); }
+    const std::uint16_t* FundCodeData() const { return fundCodes.data(); }
+
+    /**
+     * count/sum/min/max of amount WHERE fund == fundCode AND amount > aboveCents
+     */
+    AmountSummary Summarize(int fundCode, std::int64_t aboveCents, KernelMode mode = eKERNEL_AUTO) const;
+
+    /**
+     * Row numbers WHERE fund == fundCode AND amount > aboveCents, in order
+     */
+    std::vector<std::uint32_t> Filter(int fundCode, std::int64_t aboveCents, KernelMode mode = eKERNEL_AUTO) const;
+
+    std::size_t MemoryBytes() const;
+};
+
+#endif /*!_BIDCOLUMNS_HPP_*/
@@ -0,0 +1,256 @@
+#include <cctype>
+#include "BidFilter.hpp"
+using namespace std;
+
+namespace {
+
+const char* const COLUMN_NAMES[] = { "fund", "department", "paystatus" };
+
+bool sameWord(string_view a, string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Recursive descent over the filter grammar:
+ *
+ *   or     := and { OR and }
+ *   and    := unary { AND unary }
+ *   unary  := NOT unary | '(' or ')' | column '=' value
+ */
+class FilterParser {
+    string_view text;
+    size_t pos;
+
+    void skipSpace() {
+        while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    }
+
+    // a bare word: anything up to a space, '=', or a parenthesis
+    string_view word() {
+        skipSpace();
+        const size_t start = pos;
+        while (pos < text.size() && !isspace(static_cast<unsigned char>(text[pos]))
+               && text[pos] != '=' && text[pos] != '(' && text[pos] != ')') {
+            ++pos;
+        }
+        return text.substr(start, pos - start);
+    }
+
+    // consume the keyword if it comes next
+    bool keyword(const char* name) {
+        const size_t start = pos;
+        if (sameWord(word(), name)) {
+            return true;
+        }
+        pos = start;
+        return false;
+    }
+
+    bool symbol(char c) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool fail(const string& what) {
+        problem = what + " at column " + to_string(pos + 1);
+        return false;
+    }
+
+    bool parseValue(string& value) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == '"') {
+            const size_t close = text.find('"', pos + 1);
+            if (close == string_view::npos) {
+                return fail("unclosed quote");
+            }
+            value = string(text.substr(pos + 1, close - pos - 1));
+            pos = close + 1;
+            return true;
+        }
+        value = string(word());
+        return !value.empty() || fail("expected a value");
+    }
+
+    bool parseUnary(BidFilter& filter) {
+        if (keyword("not")) {
+            BidFilter operand;
+            if (!parseUnary(operand)) {
+                return false;
+            }
+            filter = operand.Not();
+            return true;
+        }
+        if (symbol('(')) {
+            if (!parseOr(filter)) {
+                return false;
+            }
+            return symbol(')') || fail("expected )");
+        }
+        const string_view name = word();
+        if (name.empty()) {
+            return fail("expected a column");
+        }
+        int column = 0;
+        while (column < eFILTER_COLUMNS && !sameWord(name, COLUMN_NAMES[column])) {
+            ++column;
+        }
+        if (column == eFILTER_COLUMNS) {
+            return fail("unknown column " + string(name) + ", expected fund, department or paystatus");
+        }
+        if (!symbol('=')) {
+            return fail("expected =");
+        }
+        string value;
+        if (!parseValue(value)) {
+            return false;
+        }
+        filter = BidFilter::Equals(FilterColumn(column), move(value));
+        return true;
+    }
+
+    bool parseAnd(BidFilter& filter) {
+        if (!parseUnary(filter)) {
+            return false;
+        }
+        while (keyword("and")) {
+            BidFilter right;
+            if (!parseUnary(right)) {
+                return false;
+            }
+            filter = filter.And(right);
+        }
+        return true;
+    }
+
+    bool parseOr(BidFilter& filter) {
+        if (!parseAnd(filter)) {
+            return false;
+        }
+        while (keyword("or")) {
+            BidFilter right;
+            if (!parseAnd(right)) {
+                return false;
+            }
+            filter = filter.Or(right);
+        }
+        return true;
+    }
+
+public:
+    string problem;
+
+    explicit FilterParser(string_view text) : text(text), pos(0) {}
+
+    bool Parse(BidFilter& filter) {
+        if (!parseOr(filter)) {
+            return false;
+        }
+        skipSpace();
+        return pos == text.size() || fail("unexpected " + string(text.substr(pos, 16)));
+    }
+};
+
+void appendQuoted(string& text, const string& value) {
+    bool bare = !value.empty();
+    for (char c : value) {
+        bare = bare && !isspace(static_cast<unsigned char>(c)) && c != '(' && c != ')' && c != '=' && c != '"';
+    }
+    text += bare ? value : '"' + value + '"';
+}
+}
+
+const string& filterValue(const Bid& bid, FilterColumn column) {
+    switch (column) {
+    case eFILTER_DEPARTMENT:
+        return bid.department;
+    case eFILTER_PAY_STATUS:
+        return bid.payStatus;
+    default:
+        return bid.fund;
+    }
+}
+
+const char* filterColumnName(FilterColumn column) {
+    return COLUMN_NAMES[column];
+}
+
+/**
+ * Constructor
+ */
+BidFilter::BidFilter()
+    : root(make_shared<const Node>(Node{ eFILTER_ALL, eFILTER_FUND, string(), nullptr, nullptr })) {
+}
+
+BidFilter BidFilter::Equals(FilterColumn column, string value) {
+    return BidFilter(make_shared<const Node>(Node{ eFILTER_EQUALS, column, move(value), nullptr, nullptr }));
+}
+
+BidFilter BidFilter::And(const BidFilter& other) const {
+    return BidFilter(make_shared<const Node>(Node{ eFILTER_AND, eFILTER_FUND, string(), root, other.root }));
+}
+
+BidFilter BidFilter::Or(const BidFilter& other) const {
+    return BidFilter(make_shared<const Node>(Node{ eFILTER_OR, eFILTER_FUND, string(), root, other.root }));
+}
+
+BidFilter BidFilter::Not() const {
+    return BidFilter(make_shared<const Node>(Node{ eFILTER_NOT, eFILTER_FUND, string(), root, nullptr }));
+}
+
+bool BidFilter::matches(const Node& node, const Bid& bid) {
+    switch (node.kind) {
+    case eFILTER_EQUALS:
+        return filterValue(bid, node.column) == node.value;
+    case eFILTER_AND:
+        return matches(*node.left, bid) && matches(*node.right, bid);
+    case eFILTER_OR:
+        return matches(*node.left, bid) || matches(*node.right, bid);
+    case eFILTER_NOT:
+        return !matches(*node.left, bid);
+    default:
+        return true;
+    }
+}
+
+string BidFilter::ToString() const {
+    string text;
+    switch (Kind()) {
+    case eFILTER_EQUALS:
+        text = string(filterColumnName(Column())) + "=";
+        appendQuoted(text, Value());
+        return text;
+    case eFILTER_AND:
+        return "(" + Left().ToString() + " and " + Right().ToString() + ")";
+    case eFILTER_OR:
+        return "(" + Left().ToString() + " or " + Right().ToString() + ")";
+    case eFILTER_NOT:
+        return "not " + Left().ToString();
+    default:
+        return "all";
+    }
+}
+
+bool BidFilter::Parse(string_view text, BidFilter& filter, string& problem) {
+    FilterParser parser(text);
+    BidFilter parsed;
+    if (!parser.Parse(parsed)) {
+        problem = parser.problem;
+        return false;
+    }
+    filter = parsed;
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef     _BIDFILTER_HPP_
+# define    _BIDFILTER_HPP_
+
+# include <memory>
+# include <string>
+# include <string_view>
+# include "Bid.hpp"
+
+// the low-cardinality columns a filter can test
+enum FilterColumn {
+    eFILTER_FUND = 0,
+    eFILTER_DEPARTMENT = 1,
+    eFILTER_PAY_STATUS = 2,
+    eFILTER_COLUMNS = 3
+};
+
+enum FilterKind {
+    eFILTER_ALL = 0,
+    eFILTER_EQUALS = 1,
+    eFILTER_AND = 2,
+    eFILTER_OR = 3,
+    eFILTER_NOT = 4
+};
+
+// the value of a filter column in a bid
+const std::string& filterValue(const Bid& bid, FilterColumn column);
+const char* filterColumnName(FilterColumn column);
+
+/**
+ * A condition on a bid's fund, department and pay status: column =
+ * value tests combined with AND, OR and NOT. Matches tests one bid, for
+ * a scan; BidBitmapIndex answers the same filter from bitmaps.
+ *
+ * Filters are immutable and share their subexpressions, so copying one
+ * is cheap.
+ */
+class BidFilter {
+
+private:
+    struct Node {
+        FilterKind kind;
+        FilterColumn column;
+        std::string value;
+        std::shared_ptr<const Node> left;
+        std::shared_ptr<const Node> right;
+    };
+
+    std::shared_ptr<const Node> root;
+
+    explicit BidFilter(std::shared_ptr<const Node> root) : root(std::move(root)) {}
+    static bool matches(const Node& node, const Bid& bid);
+
+public:
+    // matches every bid
+    BidFilter();
+
+    static BidFilter Equals(FilterColumn column, std::string value);
+    BidFilter And(const BidFilter& other) const;
+    BidFilter Or(const BidFilter& other) const;
+    BidFilter Not() const;
+
+    FilterKind Kind() const { return root->kind; }
+    FilterColumn Column() const { return root->column; }
+    const std::string& Value() const { return root->value; }
+    // the operands of AND and OR, and of NOT on the left
+    BidFilter Left() const { return BidFilter(root->left); }
+    BidFilter Right() const { return BidFilter(root->right); }
+
+    bool Matches(const Bid& bid) const { return matches(*root, bid); }
+    std::string ToString() const;
+
+    /**
+     * Read a filter such as
+     *
+     *   department="DRUG TASK FORCE" and not fund=Enterprise
+     *
+     * Columns are fund, department and paystatus. A value with spaces
+     * goes in double quotes. NOT binds tightest, then AND, then OR, and
+     * parentheses group. Keywords and column names ignore case; values
+     * don't.
+     *
+     * @param text the filter
+     * @param filter set to the filter when it reads
+     * @param problem set to what is wrong when it doesn't
+     * @return whether text is a filter
+     */
+    static bool Parse(std::string_view text, BidFilter& filter, std::string& problem);
+};
+
+#endif /*!_BIDFILTER_HPP_*/
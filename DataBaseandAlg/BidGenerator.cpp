@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "BidGenerator.hpp"
+#include "BidSnapshot.hpp"
+using namespace std;
+
+namespace {
+
+const char* const ORDER_NAMES[] = { "sorted", "shuffled", "zipf", "duplicates" };
+// rows generated per write to the output file
+const size_t WRITE_CHUNK = 1 << 16;
+// spread of the log-normal factor on amounts
+const double AMOUNT_SIGMA = 0.25;
+
+/**
+ * Position of the space that splits a title's words in half, or npos
+ * for a single word
+ */
+size_t middleSpace(string_view title) {
+    const size_t spaces = count(title.begin(), title.end(), ' ');
+    size_t pos = string_view::npos;
+    for (size_t i = 0; i < (spaces + 1) / 2; ++i) {
+        pos = title.find(' ', pos + 1);
+    }
+    return pos;
+}
+
+// append a value as one CSV field, quoted when it holds a separator, quote or newline
+void appendField(string& text, string_view value) {
+    if (value.find_first_of(",\"\r\n") == string_view::npos) {
+        text.append(value);
+        return;
+    }
+    text.push_back('"');
+    for (char c : value) {
+        if (c == '"') {
+            text.push_back('"');
+        }
+        text.push_back(c);
+    }
+    text.push_back('"');
+}
+
+string_view trim(string_view s) {
+    while (!s.empty() && s.front() == ' ') {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && s.back() == ' ') {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+}
+
+/**
+ * Constructor
+ */
+BidGenerator::BidGenerator(const string& sourceCsv, const Config& config)
+    : source(sourceCsv), config(config) {
+    BidSnapshot::RequireCsv(source.view(), sourceCsv);
+    csv::Reader reader(source.view());
+    vector<string_view> fields;
+    if (!reader.next(fields)) {
+        throw csv::Error(string("No Data in ").append(sourceCsv));
+    }
+    columns = fields.size();
+    layout = bidLayoutFromHeader(fields);
+    inventory = columns;
+    for (size_t c = 0; c < columns; ++c) {
+        header.append(c == 0 ? "" : ",").append(fields[c]);
+        if (trim(csv::unquote(fields[c])) == "Inventory ID") {
+            inventory = c;
+        }
+    }
+    header.push_back('\n');
+
+    while (reader.next(fields)) {
+        if (fields.size() != columns) {
+            continue;
+        }
+        records.push_back(fields);
+        Bid bid = bidFromFields(fields, layout);
+        titles.push_back(move(bid.title));
+        amounts.push_back(bid.amount);
+    }
+    if (records.empty()) {
+        throw csv::Error(string("No Data in ").append(sourceCsv));
+    }
+    if (config.idStride == 0 || config.duplicates == 0 || !(config.zipfSkew > 1.0)
+        || (config.rows != 0 && (config.rows - 1) > (UINT32_MAX - config.firstId) / config.idStride)) {
+        throw csv::Error("Generator config gives bid ids past 32 bits or has a zero stride, "
+                         "duplicate count or a Zipf skew of 1 or less");
+    }
+
+    permuteBits = 1;
+    while ((uint64_t(1) << permuteBits) < config.rows) {
+        ++permuteBits;
+    }
+    Rewind();
+}
+
+void BidGenerator::Rewind() {
+    random.seed(config.seed);
+    for (uint64_t& key : permuteKeys) {
+        key = random();
+    }
+    produced = 0;
+    nextInventory = 80000;
+}
+
+/**
+ * A fixed random permutation of [0, rows): rounds of key xor, odd
+ * multiply and xorshift are each one-to-one on permuteBits bits, and
+ * values that land past rows walk the cycle on until they come back
+ * in range. No table, so it costs nothing at 100M rows.
+ */
+uint64_t BidGenerator::permute(uint64_t i) const {
+    const uint64_t mask = (uint64_t(1) << permuteBits) - 1;
+    const unsigned shift = permuteBits / 2 + 1;
+    uint64_t x = i;
+    do {
+        for (uint64_t key : permuteKeys) {
+            x = ((x ^ key) * 0x9E3779B97F4A7C15ull) & mask;
+            x ^= x >> shift;
+        }
+    } while (x >= config.rows);
+    return x;
+}
+
+// the k of the next row's id
+uint64_t BidGenerator::idIndex() {
+    switch (config.order) {
+    case eIDS_SORTED:
+        return produced;
+    case eIDS_ZIPF: {
+        // inverse of the continuous power law over [1, rows + 1), then
+        // permuted so the popular ids don't all sit at the low end
+        const double a = 1.0 - config.zipfSkew;
+        const double u = uniform_real_distribution<double>(0.0, 1.0)(random);
+        const double rank = pow(1.0 + u * (pow(double(config.rows) + 1.0, a) - 1.0), 1.0 / a);
+        return permute(min<uint64_t>(uint64_t(rank), config.rows) - 1);
+    }
+    case eIDS_DUPLICATES: {
+        const size_t distinct = max<size_t>(1, config.rows / config.duplicates);
+        return permute(pick(distinct));
+    }
+    default:
+        return permute(produced);
+    }
+}
+
+size_t BidGenerator::pick(size_t count) {
+    return uniform_int_distribution<size_t>(0, count - 1)(random);
+}
+
+void BidGenerator::appendTitle(string& text) {
+    const string& first = titles[pick(titles.size())];
+    if (random() & 1) {
+        appendField(text, first);
+        return;
+    }
+    const string& second = titles[pick(titles.size())];
+    const size_t firstCut = middleSpace(first);
+    const size_t secondCut = middleSpace(second);
+    if (firstCut == string::npos || secondCut == string::npos) {
+        appendField(text, first);
+        return;
+    }
+    appendField(text, first.substr(0, firstCut) + second.substr(secondCut));
+}
+
+/**
+ * A quoted list of inventory numbers becomes the same number of fresh
+ * ones; a single id or an empty field is kept as it is
+ */
+void BidGenerator::appendInventory(string& text, string_view field) {
+    const string value = csv::unquote(field);
+    if (value.find(',') == string::npos) {
+        text.append(field);
+        return;
+    }
+    const size_t items = count(value.begin(), value.end(), ',') + 1;
+    text.push_back('"');
+    for (size_t i = 0; i < items; ++i) {
+        text.append(i == 0 ? "" : ", ").append(to_string(nextInventory++));
+    }
+    text.push_back('"');
+}
+
+void BidGenerator::appendRow(string& text) {
+    const vector<string_view>& row = records[pick(records.size())];
+    for (size_t c = 0; c < columns; ++c) {
+        if (c != 0) {
+            text.push_back(',');
+        }
+        if (c == layout.bidId) {
+            text += to_string(config.firstId + config.idStride * idIndex());
+        }
+        else if (c == layout.title) {
+            appendTitle(text);
+        }
+        else if (c == layout.fund) {
+            text.append(records[pick(records.size())][c]);
+        }
+        else if (c == layout.amount) {
+            const double amount = amounts[pick(amounts.size())]
+                * lognormal_distribution<double>(0.0, AMOUNT_SIGMA)(random);
+            char money[32];
+            snprintf(money, sizeof(money), "$%.2f", amount);
+            text += money;
+        }
+        else if (c == inventory) {
+            appendInventory(text, records[pick(records.size())][c]);
+        }
+        else {
+            text.append(row[c]);
+        }
+    }
+    text.push_back('\n');
+    ++produced;
+}
+
+size_t BidGenerator::Append(string& text, size_t maxRows) {
+    const size_t rows = min(maxRows, Remaining());
+    for (size_t i = 0; i < rows; ++i) {
+        appendRow(text);
+    }
+    return rows;
+}
+
+size_t BidGenerator::NextChunk(string& text, size_t maxRows) {
+    text = header;
+    return Append(text, maxRows);
+}
+
+void BidGenerator::Write(const string& path) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(header.data(), header.size());
+    string text;
+    while (Remaining() != 0 && out) {
+        text.clear();
+        Append(text, WRITE_CHUNK);
+        out.write(text.data(), text.size());
+    }
+    if (!out.flush()) {
+        throw csv::Error(string("Failed to write ").append(path));
+    }
+}
+
+const char* BidGenerator::OrderName(IdOrder order) {
+    return ORDER_NAMES[order];
+}
+
+bool BidGenerator::ParseOrder(string_view name, IdOrder& order) {
+    for (int i = 0; i < 4; ++i) {
+        if (name == ORDER_NAMES[i]) {
+            order = IdOrder(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,128 @@
+#ifndef     _BIDGENERATOR_HPP_
+# define    _BIDGENERATOR_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <random>
+# include <string>
+# include <string_view>
+# include <vector>
+# include "Bid.hpp"
+# include "CSVreader.hpp"
+
+/**
+ * Synthetic eBid export of any size, for scale tests far past the bundled
+ * files. Rows have the source file's header and columns. Every value is
+ * drawn from what the source file holds:
+ *
+ *  - a title is a real one half the time, otherwise the first words of
+ *    one title followed by the last words of another,
+ *  - the fund comes from a random source row, so funds keep their mix,
+ *  - the amount is a random source amount scaled by a log-normal factor,
+ *  - a multi-valued Inventory ID gets as many fresh inventory numbers
+ *    as a random source row has, quoted as one field,
+ *  - every other column is copied from one random source row.
+ *
+ * Bid ids are firstId + idStride * k, with k chosen by the IdOrder.
+ * Generation is deterministic for a seed and doesn't depend on how the
+ * rows are split into chunks. Rows come out as CSV text, written to a
+ * file or handed over a chunk at a time, so a loader can parse them
+ * straight from memory.
+ */
+class BidGenerator {
+
+public:
+    enum IdOrder {
+        // k = 0, 1, 2, ...
+        eIDS_SORTED = 0,
+        // each k in [0, rows) once, in random order
+        eIDS_SHUFFLED = 1,
+        // k drawn with Zipf skew, so a few ids repeat very often
+        eIDS_ZIPF = 2,
+        // k uniform over rows / duplicates values
+        eIDS_DUPLICATES = 3
+    };
+
+    struct Config {
+        std::size_t rows = 1000;
+        IdOrder order = eIDS_SHUFFLED;
+        std::uint32_t firstId = 100000;
+        std::uint32_t idStride = 1;
+        // exponent of the Zipf distribution, above 1
+        double zipfSkew = 1.2;
+        // average copies of each id with eIDS_DUPLICATES
+        unsigned duplicates = 8;
+        std::uint64_t seed = 1;
+    };
+
+private:
+    csv::MappedFile source;
+    std::vector<std::vector<std::string_view>> records;
+    std::vector<std::string> titles;
+    std::vector<double> amounts;
+    std::string header;
+    BidLayout layout;
+    // column of the Inventory ID, or columns when there is none
+    std::size_t inventory;
+    std::size_t columns;
+
+    Config config;
+    std::mt19937_64 random;
+    std::size_t produced;
+    std::uint64_t nextInventory;
+    // permutation domain is the 2^permuteBits just above rows
+    unsigned permuteBits;
+    std::uint64_t permuteKeys[3];
+
+    std::uint64_t permute(std::uint64_t i) const;
+    std::uint64_t idIndex();
+    std::size_t pick(std::size_t count);
+    void appendTitle(std::string& text);
+    void appendInventory(std::string& text, std::string_view field);
+    void appendRow(std::string& text);
+
+public:
+    /**
+     * Learn the distributions from a CSV export
+     *
+     * @throws csv::Error if the export can't be read, is a snapshot, has
+     *         no data, or the config asks for ids past 32 bits
+     */
+    BidGenerator(const std::string& sourceCsv, const Config& config);
+    BidGenerator(const BidGenerator&) = delete;
+    BidGenerator& operator=(const BidGenerator&) = delete;
+
+    // the header line, newline included
+    const std::string& Header() const { return header; }
+    std::size_t Remaining() const { return config.rows - produced; }
+    // start again from the first row; the same rows come out
+    void Rewind();
+
+    /**
+     * Append the next rows, without a header
+     *
+     * @return rows appended, 0 once all of them are out
+     */
+    std::size_t Append(std::string& text, std::size_t maxRows);
+
+    /**
+     * Replace text by a complete CSV of the header and the next rows, the
+     * form streamCsvBids takes
+     *
+     * @return rows in the chunk, 0 once all of them are out
+     */
+    std::size_t NextChunk(std::string& text, std::size_t maxRows);
+
+    /**
+     * Write the header and every remaining row to a file
+     *
+     * @throws csv::Error if the file can't be written
+     */
+    void Write(const std::string& path);
+
+    static const char* OrderName(IdOrder order);
+    // parse "sorted", "shuffled", "zipf" or "duplicates"
+    static bool ParseOrder(std::string_view name, IdOrder& order);
+};
+
+#endif /*!_BIDGENERATOR_HPP_*/
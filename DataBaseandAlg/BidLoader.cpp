@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include "BidLoader.hpp"
+#include "Currency.hpp"
+#include "ThreadPool.hpp"
+using namespace std;
+
+namespace {
+
+// ranges smaller than this aren't worth a task of their own
+const size_t MIN_CHUNK_BYTES = 1 << 20;
+// more ranges than threads so one slow range doesn't hold up the rest
+const unsigned CHUNKS_PER_THREAD = 4;
+
+/**
+ * Find the first record boundary at or after pos
+ *
+ * @param text the whole file
+ * @param pos where to start looking
+ * @param quoted whether pos is inside a quoted field
+ * @return offset just past the first newline outside quotes
+ */
+size_t nextRecordStart(string_view text, size_t pos, bool quoted) {
+    for (; pos < text.size(); ++pos) {
+        if (text[pos] == '"') {
+            quoted = !quoted;
+        }
+        else if (text[pos] == '\n' && !quoted) {
+            return pos + 1;
+        }
+    }
+    return text.size();
+}
+
+}
+
+vector<Bid> loadBidsParallel(const string& csvPath, unsigned threads) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    vector<Bid> bids;
+
+    try {
+        csv::MappedFile file(csvPath);
+        if (BidSnapshot::IsSnapshot(file.view())) {
+            return BidSnapshot(csvPath).ToBids();
+        }
+        string_view text = file.view();
+        vector<string_view> fields;
+
+        csv::Reader header(text);
+        if (!header.next(fields)) {
+            throw csv::Error(string("No Data in ").append(csvPath));
+        }
+        const size_t columns = fields.size();
+        const BidLayout layout = bidLayoutFromHeader(fields);
+        const size_t dataStart = header.offset();
+
+        ThreadPool pool(threads);
+        size_t chunkCount = max<size_t>(1, (text.size() - dataStart) / MIN_CHUNK_BYTES);
+        chunkCount = min<size_t>(chunkCount, size_t(pool.Size()) * CHUNKS_PER_THREAD);
+
+        // equal byte ranges; cut[i] may land in the middle of a record
+        vector<size_t> cut(chunkCount + 1);
+        for (size_t i = 0; i <= chunkCount; ++i) {
+            cut[i] = dataStart + (text.size() - dataStart) * i / chunkCount;
+        }
+
+        // an odd number of quotes before a cut means it is inside a quoted field
+        vector<char> oddQuotes(chunkCount);
+        for (size_t i = 0; i < chunkCount; ++i) {
+            pool.Submit([&, i] {
+                oddQuotes[i] = count(text.begin() + cut[i], text.begin() + cut[i + 1], '"') & 1;
+            });
+        }
+        pool.Wait();
+
+        vector<size_t> start(chunkCount + 1);
+        bool quoted = false;
+        start[0] = dataStart;
+        start[chunkCount] = text.size();
+        for (size_t i = 1; i < chunkCount; ++i) {
+            quoted = quoted != (oddQuotes[i - 1] != 0);
+            start[i] = max(start[i - 1], nextRecordStart(text, cut[i], quoted));
+        }
+
+        vector<vector<Bid>> parts(chunkCount);
+        for (size_t i = 0; i < chunkCount; ++i) {
+            pool.Submit([&, i] {
+                csv::Reader reader(text.substr(start[i], start[i + 1] - start[i]));
+                vector<string_view> chunkFields;
+                while (reader.next(chunkFields)) {
+                    if (chunkFields.size() != columns) {
+                        throw csv::Error("corrupted data !");
+                    }
+                    parts[i].push_back(bidFromFields(chunkFields, layout));
+                }
+            });
+        }
+        pool.Wait();
+
+        size_t total = 0;
+        for (const vector<Bid>& part : parts) {
+            total += part.size();
+        }
+        bids.reserve(total);
+        for (vector<Bid>& part : parts) {
+            move(part.begin(), part.end(), back_inserter(bids));
+        }
+    }
+    catch (csv::Error& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return bids;
+}
+
+unsigned int loadBidStore(const string& csvPath, BidStore& store) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    csv::MappedFile file(csvPath);
+    if (BidSnapshot::IsSnapshot(file.view())) {
+        BidSnapshot snapshot(csvPath);
+        for (size_t i = 0; i < snapshot.Size(); ++i) {
+            uint32_t bidId = 0;
+            if (!bidIdToKey(snapshot.BidId(i), bidId)) {
+                throw csv::Error("bad bid id: " + string(snapshot.BidId(i)));
+            }
+            store.Add(bidId, snapshot.Title(i), snapshot.Fund(i), llround(snapshot.Amount(i) * 100));
+        }
+        return static_cast<unsigned int>(snapshot.Size());
+    }
+    csv::Reader reader(file.view());
+    vector<string_view> fields;
+    string titleScratch;
+    string idScratch;
+    string fundScratch;
+    unsigned int count = 0;
+
+    if (!reader.next(fields)) {
+        throw csv::Error(string("No Data in ").append(csvPath));
+    }
+    const size_t columns = fields.size();
+    const BidLayout layout = bidLayoutFromHeader(fields);
+
+    while (reader.next(fields)) {
+        if (fields.size() != columns) {
+            throw csv::Error("corrupted data !");
+        }
+
+        string_view id = csv::unquote(fields[layout.bidId], idScratch);
+        uint32_t bidId = 0;
+        from_chars_result res = from_chars(id.data(), id.data() + id.size(), bidId);
+        if (res.ec != errc() || res.ptr != id.data() + id.size()) {
+            throw csv::Error("bad bid id: " + string(id));
+        }
+
+        int64_t cents;
+        parseCents(fields[layout.amount], cents);
+        store.Add(bidId, csv::unquote(fields[layout.title], titleScratch),
+            csv::unquote(fields[layout.fund], fundScratch), cents);
+        ++count;
+    }
+    return count;
+}
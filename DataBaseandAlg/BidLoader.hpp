@@ -0,0 +1,91 @@
+#ifndef     _BIDLOADER_HPP_
+# define    _BIDLOADER_HPP_
+
+# include <string>
+# include <string_view>
+# include <vector>
+# include "Bid.hpp"
+# include "BidSnapshot.hpp"
+# include "BidStore.hpp"
+# include "CSVreader.hpp"
+
+/**
+ * Parse CSV text already in memory, header first, and hand each bid in
+ * it to a sink. Generated data can go through the loader this way
+ * without ever being written to disk.
+ *
+ * @param csvText the header and records
+ * @param name what to call the text in errors, e.g. its file name
+ * @param sink callable taking a Bid&& for every record
+ * @return the number of bids read
+ */
+template <typename Sink>
+unsigned int streamCsvBids(std::string_view csvText, const std::string& name, Sink sink) {
+    csv::Reader reader(csvText);
+    std::vector<std::string_view> fields;
+    unsigned int count = 0;
+
+    // the header tells us how many fields every record must have
+    if (!reader.next(fields)) {
+        throw csv::Error(std::string("No Data in ").append(name));
+    }
+    const std::size_t columns = fields.size();
+    const BidLayout layout = bidLayoutFromHeader(fields);
+
+    while (reader.next(fields)) {
+        if (fields.size() != columns) {
+            throw csv::Error("corrupted data !");
+        }
+        sink(bidFromFields(fields, layout));
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * Map a CSV file into memory and hand each bid in it to a sink,
+ * without keeping the raw lines or a Row per record around. A
+ * BidSnapshot is recognised by its header and read instead of parsed.
+ *
+ * @param csvPath the path to the CSV file or snapshot to load
+ * @param sink callable taking a Bid&& for every record
+ * @return the number of bids read
+ */
+template <typename Sink>
+unsigned int streamBids(const std::string& csvPath, Sink sink) {
+    csv::MappedFile file(csvPath);
+    if (BidSnapshot::IsSnapshot(file.view())) {
+        BidSnapshot snapshot(csvPath);
+        for (std::size_t i = 0; i < snapshot.Size(); ++i) {
+            sink(snapshot.Materialize(i));
+        }
+        return static_cast<unsigned int>(snapshot.Size());
+    }
+    return streamCsvBids(file.view(), csvPath, sink);
+}
+
+/**
+ * Load a CSV file into a vector using several threads. The file is cut
+ * into byte ranges that are moved forward to the next record boundary
+ * (outside quotes), parsed on a thread pool and concatenated, so the
+ * result is in file order exactly like the sequential loaders. A
+ * BidSnapshot is copied out as it is, with nothing to parse.
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param threads worker count, 0 for every hardware thread
+ * @return a container holding all the bids read
+ */
+std::vector<Bid> loadBidsParallel(const std::string& csvPath, unsigned threads = 0);
+
+/**
+ * Load a CSV file straight into a BidStore, appending to what it holds.
+ * No Bid or per-field string is built on the way. A BidSnapshot is
+ * copied in record by record.
+ *
+ * @param csvPath the path to the CSV file or snapshot to load
+ * @param store the store to append to
+ * @return the number of bids read
+ */
+unsigned int loadBidStore(const std::string& csvPath, BidStore& store);
+
+#endif /*!_BIDLOADER_HPP_*/
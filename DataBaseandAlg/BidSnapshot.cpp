@@ -0,0 +1,240 @@
+#include <cstring>
+#include <fstream>
+#include "BidSnapshot.hpp"
+using namespace std;
+
+namespace {
+
+const char MAGIC[8] = { 'B', 'I', 'D', 'S', 'N', 'A', 'P', '\0' };
+const size_t SECTION_ALIGN = 64;
+
+const uint64_t PRIME1 = 11400714785074694791ull;
+const uint64_t PRIME2 = 14029467366897019727ull;
+const uint64_t PRIME3 = 1609587929392839161ull;
+
+uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t load64(const char* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+size_t alignUp(size_t offset) {
+    return (offset + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+}
+
+/**
+ * Constructor
+ */
+BidSnapshot::BidSnapshot(const string& path, bool verify) : file(path) {
+    check(file.size() >= sizeof(Header) && IsSnapshot(file.view()), path, "is not a bid snapshot");
+    header = reinterpret_cast<const Header*>(file.data());
+    check(header->version == VERSION && header->headerBytes == sizeof(Header), path,
+          "was written by another version of the program");
+
+    const uint64_t size = file.size();
+    const uint64_t recordsEnd = sizeof(Header) + header->bidCount * sizeof(Record);
+    check(header->bidCount <= size / sizeof(Record)
+          && header->textOffset >= recordsEnd && header->textOffset <= size
+          && header->textBytes <= size - header->textOffset
+          && header->indexOffset >= header->textOffset + header->textBytes
+          && header->indexOffset % sizeof(IndexSlot) == 0 && header->indexOffset <= size
+          && header->indexSlots != 0 && (header->indexSlots & (header->indexSlots - 1)) == 0
+          && header->indexSlots <= (size - header->indexOffset) / sizeof(IndexSlot),
+          path, "is truncated or has a damaged header");
+
+    records = reinterpret_cast<const Record*>(file.data() + sizeof(Header));
+    text = file.data() + header->textOffset;
+    index = reinterpret_cast<const IndexSlot*>(file.data() + header->indexOffset);
+    if (!verify) {
+        return;
+    }
+
+    uint64_t sum = checksum(reinterpret_cast<const char*>(records), header->bidCount * sizeof(Record), 0);
+    sum = checksum(text, header->textBytes, sum);
+    sum = checksum(reinterpret_cast<const char*>(index), header->indexSlots * sizeof(IndexSlot), sum);
+    check(sum == header->checksum, path, "fails its checksum");
+
+    bool inside = true;
+    for (size_t i = 0; i < Size(); ++i) {
+        const Record& r = records[i];
+        inside = inside && r.text <= header->textBytes
+            && uint64_t(r.bidIdLength) + r.titleLength + r.fundLength + r.departmentLength + r.payStatusLength
+                <= header->textBytes - r.text;
+    }
+    for (size_t i = 0; i < header->indexSlots; ++i) {
+        inside = inside && index[i].record <= header->bidCount;
+    }
+    check(inside, path, "has a record pointing outside it");
+}
+
+void BidSnapshot::check(bool ok, const string& path, const char* problem) const {
+    if (!ok) {
+        throw csv::Error(path + " " + problem);
+    }
+}
+
+bool BidSnapshot::IsSnapshot(string_view data) {
+    return data.size() >= sizeof(MAGIC) && memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void BidSnapshot::RequireCsv(string_view data, const string& path) {
+    if (IsSnapshot(data)) {
+        throw csv::Error(path + " is a bid snapshot; this needs a CSV export");
+    }
+}
+
+/**
+ * murmur3's 32-bit finalizer, the same spread RobinHoodHashTable uses
+ */
+uint32_t BidSnapshot::mix(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6bu;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35u;
+    key ^= key >> 16;
+    return key;
+}
+
+/**
+ * 64-bit checksum in the style of xxHash64: four independent lanes take
+ * one 8-byte word each per round, so the multiplies overlap and the
+ * whole file is checked at close to memory speed
+ */
+uint64_t BidSnapshot::checksum(const char* data, size_t size, uint64_t seed) {
+    uint64_t lanes[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 };
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            lanes[l] = rotl(lanes[l] + load64(data + i + 8 * l) * PRIME2, 31) * PRIME1;
+        }
+    }
+    uint64_t hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18) + size;
+    for (; i + 8 <= size; i += 8) {
+        hash ^= rotl(load64(data + i) * PRIME2, 31) * PRIME1;
+        hash = rotl(hash, 27) * PRIME1 + PRIME3;
+    }
+    for (; i < size; ++i) {
+        hash ^= uint8_t(data[i]) * PRIME3;
+        hash = rotl(hash, 11) * PRIME1;
+    }
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void BidSnapshot::Write(const string& path, const vector<Bid>& bids) {
+    vector<Record> recordList(bids.size());
+    string textSection;
+    for (size_t i = 0; i < bids.size(); ++i) {
+        const Bid& bid = bids[i];
+        if (bid.bidId.size() > 0xFFFF || bid.title.size() > 0xFFFF || bid.fund.size() > 0xFFFF
+            || bid.department.size() > 0xFFFF || bid.payStatus.size() > 0xFFFF) {
+            throw csv::Error("Bid " + bid.bidId.substr(0, 32) + " has a field too long for a snapshot");
+        }
+        Record& r = recordList[i];
+        r.amount = bid.amount;
+        r.text = textSection.size();
+        r.bidIdLength = uint16_t(bid.bidId.size());
+        r.titleLength = uint16_t(bid.title.size());
+        r.fundLength = uint16_t(bid.fund.size());
+        r.departmentLength = uint16_t(bid.department.size());
+        r.payStatusLength = uint16_t(bid.payStatus.size());
+        memset(r.reserved, 0, sizeof(r.reserved));
+        textSection += bid.bidId;
+        textSection += bid.title;
+        textSection += bid.fund;
+        textSection += bid.department;
+        textSection += bid.payStatus;
+    }
+    textSection.resize(alignUp(textSection.size()), '\0');
+
+    size_t slots = 16;
+    while (slots < 2 * bids.size()) {
+        slots *= 2;
+    }
+    vector<IndexSlot> indexSection(slots, IndexSlot{ 0, 0 });
+    for (size_t i = 0; i < bids.size(); ++i) {
+        uint32_t key;
+        if (!bidIdToKey(bids[i].bidId, key)) {
+            continue;
+        }
+        size_t j = mix(key) & (slots - 1);
+        while (indexSection[j].record != 0 && indexSection[j].key != key) {
+            j = (j + 1) & (slots - 1);
+        }
+        if (indexSection[j].record == 0) {
+            indexSection[j].key = key;
+            indexSection[j].record = uint32_t(i + 1);
+        }
+    }
+
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.headerBytes = sizeof(Header);
+    h.bidCount = bids.size();
+    h.textOffset = alignUp(sizeof(Header) + recordList.size() * sizeof(Record));
+    h.textBytes = textSection.size();
+    h.indexOffset = h.textOffset + h.textBytes;
+    h.indexSlots = slots;
+    h.checksum = checksum(reinterpret_cast<const char*>(recordList.data()), recordList.size() * sizeof(Record), 0);
+    h.checksum = checksum(textSection.data(), textSection.size(), h.checksum);
+    h.checksum = checksum(reinterpret_cast<const char*>(indexSection.data()), slots * sizeof(IndexSlot), h.checksum);
+
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(recordList.data()), recordList.size() * sizeof(Record));
+    const string padding(h.textOffset - sizeof(Header) - recordList.size() * sizeof(Record), '\0');
+    out.write(padding.data(), padding.size());
+    out.write(textSection.data(), textSection.size());
+    out.write(reinterpret_cast<const char*>(indexSection.data()), slots * sizeof(IndexSlot));
+    if (!out.flush()) {
+        throw csv::Error(string("Failed to write ").append(path));
+    }
+}
+
+Bid BidSnapshot::Materialize(size_t i) const {
+    Bid bid;
+    bid.bidId = BidId(i);
+    bid.title = Title(i);
+    bid.fund = Fund(i);
+    bid.department = Department(i);
+    bid.payStatus = PayStatus(i);
+    bid.amount = Amount(i);
+    return bid;
+}
+
+vector<Bid> BidSnapshot::ToBids() const {
+    vector<Bid> bids;
+    bids.reserve(Size());
+    for (size_t i = 0; i < Size(); ++i) {
+        bids.push_back(Materialize(i));
+    }
+    return bids;
+}
+
+size_t BidSnapshot::Find(uint32_t key) const {
+    const size_t mask = size_t(header->indexSlots - 1);
+    size_t j = mix(key) & mask;
+    // bounded, so even an unverified damaged index can't loop forever
+    for (size_t probes = 0; probes <= mask; ++probes) {
+        const IndexSlot& slot = index[j];
+        if (slot.record == 0) {
+            return NOT_FOUND;
+        }
+        if (slot.key == key) {
+            return slot.record - 1;
+        }
+        j = (j + 1) & mask;
+    }
+    return NOT_FOUND;
+}
@@ -0,0 +1,146 @@
+#ifndef     _BIDSNAPSHOT_HPP_
+# define    _BIDSNAPSHOT_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <vector>
+# include "Bid.hpp"
+# include "CSVreader.hpp"
+
+/**
+ * Binary snapshot of a bid set. It is written once after a CSV load and
+ * mapped straight back in later with nothing to parse. Layout, little
+ * endian:
+ *
+ *   header   magic "BIDSNAP", format version, where each section starts
+ *            and how long it is, and a checksum of all three sections
+ *   records  32 bytes per bid: the amount, the offset of its text and
+ *            the lengths of its id, title, fund, department and pay
+ *            status
+ *   text     every bid's id, title, fund, department and pay status
+ *            back to back
+ *   index    open-addressing table from numeric bid id to record number,
+ *            at most half full, linear probing
+ *
+ * Every reference is an offset from the start of the file, so a mapping
+ * works wherever it lands without any relocation. Bids whose id is not a
+ * plain number are stored but not indexed; for a duplicate id the index
+ * gives the first one.
+ */
+class BidSnapshot {
+
+public:
+    static const std::uint32_t VERSION = 2;
+    static const std::size_t NOT_FOUND = std::size_t(-1);
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerBytes;
+        std::uint64_t bidCount;
+        std::uint64_t textOffset;
+        std::uint64_t textBytes;
+        std::uint64_t indexOffset;
+        std::uint64_t indexSlots;
+        std::uint64_t checksum;
+    };
+
+    struct Record {
+        double amount;
+        std::uint64_t text;
+        std::uint16_t bidIdLength;
+        std::uint16_t titleLength;
+        std::uint16_t fundLength;
+        std::uint16_t departmentLength;
+        std::uint16_t payStatusLength;
+        std::uint16_t reserved[3];
+    };
+
+    struct IndexSlot {
+        std::uint32_t key;
+        // record number + 1, 0 for an empty slot
+        std::uint32_t record;
+    };
+
+    static_assert(sizeof(Header) == 64 && sizeof(Record) == 32 && sizeof(IndexSlot) == 8,
+                  "the snapshot layout is part of the file format");
+
+    csv::MappedFile file;
+    const Header* header;
+    const Record* records;
+    const char* text;
+    const IndexSlot* index;
+
+    static std::uint32_t mix(std::uint32_t key);
+    static std::uint64_t checksum(const char* data, std::size_t size, std::uint64_t seed);
+    void check(bool ok, const std::string& path, const char* problem) const;
+
+public:
+    /**
+     * Map a snapshot and check its header and that every section lies
+     * inside the file
+     *
+     * @param path the snapshot to open
+     * @param verify also check the checksum and every record against the
+     *               sections, which reads the whole file once; without it
+     *               a damaged file can give garbage bids
+     * @throws csv::Error if the file can't be mapped, is not a snapshot,
+     *         has another version or fails a check
+     */
+    explicit BidSnapshot(const std::string& path, bool verify = true);
+    BidSnapshot(const BidSnapshot&) = delete;
+    BidSnapshot& operator=(const BidSnapshot&) = delete;
+
+    /**
+     * Write bids, and an index over their ids, as a snapshot
+     *
+     * @throws csv::Error if the file can't be written or a field is over 64 KB
+     */
+    static void Write(const std::string& path, const std::vector<Bid>& bids);
+
+    // whether data, e.g. a mapped file, starts like a snapshot
+    static bool IsSnapshot(std::string_view data);
+
+    /**
+     * For readers that take only a CSV export: refuse a snapshot up front
+     * instead of parsing its bytes as text
+     *
+     * @throws csv::Error if data is a snapshot
+     */
+    static void RequireCsv(std::string_view data, const std::string& path);
+
+    std::size_t Size() const { return std::size_t(header->bidCount); }
+    std::size_t FileBytes() const { return file.size(); }
+
+    std::string_view BidId(std::size_t i) const {
+        return std::string_view(text + records[i].text, records[i].bidIdLength);
+    }
+    std::string_view Title(std::size_t i) const {
+        return std::string_view(text + records[i].text + records[i].bidIdLength, records[i].titleLength);
+    }
+    std::string_view Fund(std::size_t i) const {
+        const Record& r = records[i];
+        return std::string_view(text + r.text + r.bidIdLength + r.titleLength, r.fundLength);
+    }
+    std::string_view Department(std::size_t i) const {
+        const Record& r = records[i];
+        return std::string_view(text + r.text + r.bidIdLength + r.titleLength + r.fundLength, r.departmentLength);
+    }
+    std::string_view PayStatus(std::size_t i) const {
+        const Record& r = records[i];
+        return std::string_view(text + r.text + r.bidIdLength + r.titleLength + r.fundLength + r.departmentLength,
+                                r.payStatusLength);
+    }
+    double Amount(std::size_t i) const { return records[i].amount; }
+
+    Bid Materialize(std::size_t i) const;
+    std::vector<Bid> ToBids() const;
+
+    // the record number of the first bid with this id, or NOT_FOUND
+    std::size_t Find(std::uint32_t key) const;
+};
+
+#endif /*!_BIDSNAPSHOT_HPP_*/
@@ -0,0 +1,102 @@
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include "BidStore.hpp"
+#include "Currency.hpp"
+
+std::uint16_t BidStore::internFund(std::string_view fund) {
+    std::string key(fund);
+    auto found = fundCodes.find(key);
+    if (found != fundCodes.end()) {
+        return found->second;
+    }
+    if (fundNames.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::length_error("BidStore: too many distinct funds");
+    }
+    std::uint16_t code = static_cast<std::uint16_t>(fundNames.size());
+    fundNames.push_back(key);
+    fundCodes.emplace(std::move(key), code);
+    return code;
+}
+
+/**
+ * Append a bid
+ *
+ * @return handle of the new bid
+ */
+BidRef BidStore::Add(std::uint32_t bidId, std::string_view title, std::string_view fund, std::int64_t cents) {
+    if (title.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::length_error("BidStore: title too long");
+    }
+    if (records.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("BidStore: too many bids");
+    }
+
+    Record r;
+    r.cents = cents;
+    r.titleOffset = titles.size();
+    r.bidId = bidId;
+    r.titleLength = static_cast<std::uint16_t>(title.size());
+    r.fundCode = internFund(fund);
+
+    titles.append(title.data(), title.size());
+    records.push_back(r);
+    return BidRef{ static_cast<std::uint32_t>(records.size() - 1) };
+}
+
+/**
+ * Append a bid given in the string layout
+ *
+ * @return handle of the new bid
+ */
+BidRef BidStore::Add(const Bid& bid) {
+    std::uint32_t bidId = 0;
+    const char* first = bid.bidId.data();
+    const char* last = first + bid.bidId.size();
+    std::from_chars_result res = std::from_chars(first, last, bidId);
+    if (res.ec != std::errc() || res.ptr != last) {
+        throw std::invalid_argument("BidStore: bid id is not a number: " + bid.bidId);
+    }
+
+    // same rounding as parseCents
+    double scaled = bid.amount * 100.0;
+    std::int64_t cents = static_cast<std::int64_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    return Add(bidId, bid.title, bid.fund, cents);
+}
+
+void BidStore::Reserve(std::size_t bids, std::size_t titleBytes) {
+    records.reserve(bids);
+    titles.reserve(titleBytes);
+}
+
+void BidStore::ShrinkToFit() {
+    records.shrink_to_fit();
+    titles.shrink_to_fit();
+}
+
+void BidStore::Clear() {
+    records.clear();
+    titles.clear();
+    fundNames.clear();
+    fundCodes.clear();
+}
+
+Bid BidStore::Materialize(BidRef ref) const {
+    Bid bid;
+    bid.bidId = std::to_string(BidId(ref));
+    bid.title = std::string(Title(ref));
+    bid.fund = std::string(Fund(ref));
+    bid.amount = Amount(ref);
+    return bid;
+}
+
+std::size_t BidStore::MemoryBytes() const {
+    std::size_t bytes = records.capacity() * sizeof(Record) + titles.capacity();
+    for (const std::string& name : fundNames) {
+        // the name is held twice: in fundNames and as the map key
+        bytes += 2 * (sizeof(std::string) + name.capacity());
+    }
+    bytes += fundCodes.bucket_count() * sizeof(void*)
+        + fundCodes.size() * (sizeof(std::string) + sizeof(std::uint16_t) + 2 * sizeof(void*));
+    return bytes;
+}
@@ -0,0 +1,78 @@
+#ifndef     _BIDSTORE_HPP_
+# define    _BIDSTORE_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <unordered_map>
+# include <vector>
+# include "Bid.hpp"
+
+/**
+ * Handle to one bid inside a BidStore. Code working over a store, like
+ * BidColumns and the scans, passes these 4-byte handles around instead
+ * of whole Bid structs. The trees and hash tables still own Bids, moved
+ * in by Insert, since their callers look bids up by the string id.
+ */
+struct BidRef {
+    std::uint32_t index;
+};
+
+/**
+ * Owns a compact copy of a bid set: the numeric bid id, the amount in
+ * cents, a small dictionary code for the fund and an offset/length
+ * into one shared title arena. A record is 24 bytes plus its title,
+ * against sizeof(Bid) plus up to three heap blocks per bid.
+ */
+class BidStore {
+
+private:
+    struct Record {
+        std::int64_t cents;
+        std::uint64_t titleOffset;
+        std::uint32_t bidId;
+        std::uint16_t titleLength;
+        std::uint16_t fundCode;
+    };
+
+    std::vector<Record> records;
+    std::string titles;
+    std::vector<std::string> fundNames;
+    std::unordered_map<std::string, std::uint16_t> fundCodes;
+
+    std::uint16_t internFund(std::string_view fund);
+
+public:
+    BidRef Add(std::uint32_t bidId, std::string_view title, std::string_view fund, std::int64_t cents);
+    BidRef Add(const Bid& bid);
+    void Reserve(std::size_t bids, std::size_t titleBytes);
+    void ShrinkToFit();
+    void Clear();
+
+    std::size_t Size() const { return records.size(); }
+    BidRef At(std::size_t i) const { return BidRef{ static_cast<std::uint32_t>(i) }; }
+
+    std::uint32_t BidId(BidRef ref) const { return records[ref.index].bidId; }
+    std::int64_t Cents(BidRef ref) const { return records[ref.index].cents; }
+    double Amount(BidRef ref) const { return records[ref.index].cents / 100.0; }
+    std::uint16_t FundCode(BidRef ref) const { return records[ref.index].fundCode; }
+    std::string_view Fund(BidRef ref) const { return fundNames[records[ref.index].fundCode]; }
+    std::string_view Title(BidRef ref) const {
+        const Record& r = records[ref.index];
+        return std::string_view(titles.data() + r.titleOffset, r.titleLength);
+    }
+
+    // the fund dictionary, indexed by code
+    std::size_t FundCount() const { return fundNames.size(); }
+    const std::string& FundName(std::uint16_t code) const { return fundNames[code]; }
+    const std::vector<std::string>& FundNames() const { return fundNames; }
+
+    // rebuild a full Bid, e.g. for displayBid
+    Bid Materialize(BidRef ref) const;
+
+    // heap bytes held by the records, the title arena and the dictionary
+    std::size_t MemoryBytes() const;
+};
+
+#endif /*!_BIDSTORE_HPP_*/
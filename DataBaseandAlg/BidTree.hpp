@@ -0,0 +1,71 @@
+#ifndef     _BIDTREE_HPP_
+# define    _BIDTREE_HPP_
+
+# include <cstddef>
+# include <string>
+# include <utility>
+# include <vector>
+# include "Bid.hpp"
+
+/**
+ * Interface shared by the bid trees keyed on bidId, so the menu and the
+ * loaders can work with either the plain BinarySearchTree or a balanced
+ * one.
+ */
+class BidTree {
+public:
+    virtual ~BidTree() {}
+    virtual void InOrder() = 0;
+    // takes the bid by value so a loader can move it into its node
+    virtual void Insert(Bid bid) = 0;
+    virtual void Remove(std::string bidId) = 0;
+    // a copy of the bid, or an empty Bid when there is none
+    virtual Bid Search(std::string bidId) = 0;
+
+    // number of bids in the tree
+    virtual std::size_t Size() const = 0;
+    // nodes on the longest root to leaf path, 0 when empty
+    virtual std::size_t Height() const = 0;
+    // nodes visited by a successful Search, averaged over every bid
+    virtual double AverageDepth() const = 0;
+};
+
+/**
+ * Size, height and summed node depths (root at depth 1) of a binary tree
+ * whose nodes have left and right pointers. Walks with an explicit stack
+ * so a degenerate tree can't overflow the call stack.
+ */
+struct TreeShape {
+    std::size_t size = 0;
+    std::size_t height = 0;
+    std::size_t depthSum = 0;
+};
+
+template <class NodeT>
+TreeShape measureTree(const NodeT* root) {
+    TreeShape shape;
+    std::vector<std::pair<const NodeT*, std::size_t>> pending;
+    if (root != nullptr) {
+        pending.push_back(std::make_pair(root, std::size_t(1)));
+    }
+    while (!pending.empty()) {
+        const NodeT* node = pending.back().first;
+        std::size_t depth = pending.back().second;
+        pending.pop_back();
+
+        ++shape.size;
+        shape.depthSum += depth;
+        if (depth > shape.height) {
+            shape.height = depth;
+        }
+        if (node->left != nullptr) {
+            pending.push_back(std::make_pair(node->left, depth + 1));
+        }
+        if (node->right != nullptr) {
+            pending.push_back(std::make_pair(node->right, depth + 1));
+        }
+    }
+    return shape;
+}
+
+#endif /*!_BIDTREE_HPP_*/
@@ -0,0 +1,239 @@
+#include <vector>
+#include "BinarySearchTree.hpp"
+#include "CpuFeatures.hpp"
+#include "LatencyStats.hpp"
+using namespace std;
+
+/**
+ * Default constructor
+ */
+BinarySearchTree::BinarySearchTree() {
+    // initialize housekeeping variables
+    root = nullptr;
+}
+
+/**
+ * Destructor
+ */
+BinarySearchTree::~BinarySearchTree() {
+    // the pool frees every node in one sweep
+    nodes.Clear();
+}
+
+/**
+ * Traverse the tree in order
+ */
+void BinarySearchTree::InOrder() {
+    inOrder(root);
+}
+/**
+ * Insert a bid
+ */
+void BinarySearchTree::Insert(Bid bid) {
+    LatencyProbe probe(eLATENCY_BINARY_SEARCH_TREE, eLATENCY_INSERT);
+    // Implement inserting a bid into the tree
+    if (root == nullptr)
+    {
+        root = nodes.Create(move(bid));
+    }
+    else
+    {
+        this->addNode(root, bid);
+    }
+}
+
+/**
+ * Remove a bid
+ */
+Node* BinarySearchTree::removeNode(Node* root, string bidId)
+{
+    Node* temp;
+    if (root == NULL)
+    {
+        return root;
+    }
+
+    if (bidId < root->bid.bidId)
+    {
+        root->left = removeNode(root->left, bidId);
+    }
+    else if (bidId > root->bid.bidId)
+    {
+        root->right = removeNode(root->right, bidId);
+    }
+    else
+    {
+        if (root->left == NULL)
+        {
+            temp = root->right;
+            nodes.Destroy(root);
+            return temp;
+        }
+        else if (root->right == NULL)
+        {
+            Node* temp = root->left;
+            nodes.Destroy(root);
+            return temp;
+        }
+        Node* temp = minVal(root->right);
+        root->bid = temp->bid;
+        root->right = removeNode(root->right, temp->bid.bidId);
+    }
+    return root;
+}
+
+Node* BinarySearchTree::minVal(Node* node)
+{
+    Node* current = node;
+    while (current->left != NULL)
+    {
+        current = current->left;
+    }
+    return current;
+}
+void BinarySearchTree::Remove(string bidId) {
+    LatencyProbe probe(eLATENCY_BINARY_SEARCH_TREE, eLATENCY_REMOVE);
+    // Implement removing a bid from the tree
+    root = removeNode(root, bidId);
+
+}
+
+/**
+ * Search for a bid
+ */
+Bid BinarySearchTree::Search(string bidId) {
+    // Implement searching the tree for a bid
+    LatencyProbe probe(eLATENCY_BINARY_SEARCH_TREE, eLATENCY_SEARCH);
+
+    Bid bid;
+    Node* current = root;
+    size_t visited = 0;
+
+    while (current != nullptr)
+    {
+        ++visited;
+        if (current->bid.bidId.compare(bidId) == 0)
+        {
+            probe.Work(visited);
+            return current->bid;
+        }
+        if (bidId.compare(current->bid.bidId) < 0)
+        {
+            current = current->left;
+        }
+        else
+        {
+            current = current->right;
+        }
+    }
+    probe.Work(visited);
+    return bid;
+}
+
+namespace {
+
+// a node's bid id and its child pointers are on different cache lines
+void prefetchNode(const Node* node) {
+    prefetchRead(&node->bid.bidId);
+    prefetchRead(&node->left);
+}
+}
+
+void BinarySearchTree::SearchBatch(const uint32_t* ids, size_t count, const Bid** out) const {
+    struct Lane {
+        string bidId;
+        const Node* node;
+        size_t index;
+    };
+    Lane lanes[BATCH_LANES];
+    size_t active = 0;
+    size_t next = 0;
+    for (; active < BATCH_LANES && next < count; ++active, ++next) {
+        lanes[active].bidId = to_string(ids[next]);
+        lanes[active].node = root;
+        lanes[active].index = next;
+    }
+
+    while (active > 0) {
+        for (size_t l = 0; l < active; ) {
+            Lane& lane = lanes[l];
+            const Node* node = lane.node;
+            const int order = node == nullptr ? 0 : lane.bidId.compare(node->bid.bidId);
+            if (order != 0) {
+                lane.node = order < 0 ? node->left : node->right;
+                if (lane.node != nullptr) {
+                    prefetchNode(lane.node);
+                }
+                ++l;
+                continue;
+            }
+
+            out[lane.index] = node == nullptr ? nullptr : &node->bid;
+            if (next < count) {
+                lane.bidId = to_string(ids[next]);
+                lane.node = root;
+                lane.index = next++;
+                ++l;
+            }
+            else if (l != --active) {
+                // the last lane takes this one's place and gets its turn now
+                lane = move(lanes[active]);
+            }
+        }
+    }
+}
+
+size_t BinarySearchTree::Size() const {
+    return measureTree(root).size;
+}
+
+size_t BinarySearchTree::Height() const {
+    return measureTree(root).height;
+}
+
+double BinarySearchTree::AverageDepth() const {
+    TreeShape shape = measureTree(root);
+    return shape.size == 0 ? 0.0 : double(shape.depthSum) / shape.size;
+}
+
+/**
+ * Add a bid below some node. Walks down in a loop rather than
+ * recursing, since on an unbalanced tree the path can be as long as
+ * the file.
+ *
+ * @param node Current node in tree
+ * @param bid Bid to be added
+ */
+void BinarySearchTree::addNode(Node* node, Bid& bid) {
+    // Implement inserting a bid into the tree
+    for (;;)
+    {
+        Node*& child = node->bid.bidId.compare(bid.bidId) > 0 ? node->left : node->right;
+        if (child == nullptr)
+        {
+            child = nodes.Create(move(bid));
+            return;
+        }
+        node = child;
+    }
+}
+
+/**
+ * Display the bids below node in bidId order, using an explicit stack
+ * for the same reason as addNode
+ */
+void BinarySearchTree::inOrder(Node* node) {
+    vector<Node*> pending;
+    while (node != nullptr || !pending.empty())
+    {
+        while (node != nullptr)
+        {
+            pending.push_back(node);
+            node = node->left;
+        }
+        node = pending.back();
+        pending.pop_back();
+        displayBid(node->bid);
+        node = node->right;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef     _BINARYSEARCHTREE_HPP_
+# define    _BINARYSEARCHTREE_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <utility>
+# include "Bid.hpp"
+# include "BidTree.hpp"
+# include "NodePool.hpp"
+
+// ************************** Start Binary Tree ***************************
+struct Node {
+    Bid bid;
+    Node* left = nullptr;
+    Node* right = nullptr;
+
+    Node(Bid myBid) : bid(std::move(myBid)) {
+    }
+};
+
+//============================================================================
+// Binary Search Tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a binary search tree. Insertion does no rebalancing, so
+ * bids loaded in id order build a linked list. Nodes come from a
+ * NodePool, so destroying the tree frees them without walking it.
+ */
+class BinarySearchTree : public BidTree {
+
+private:
+    Node* root;
+    NodePool<Node> nodes;
+    void addNode(Node* node, Bid& bid);
+    void inOrder(Node* node);
+    Node* removeNode(Node* node, std::string bidId);
+    Node* minVal(Node* node);
+
+public:
+    static const std::size_t BATCH_LANES = 16;
+
+    BinarySearchTree();
+    virtual ~BinarySearchTree();
+    void InOrder();
+    void Insert(Bid bid);
+    void Remove(std::string bidId);
+    Bid Search(std::string bidId);
+
+    /**
+     * Look up count ids at once. Up to BATCH_LANES lookups walk the tree
+     * side by side, one level per turn: each prefetches the node it goes
+     * to next and waits for it only on its next turn, after the other
+     * lanes have had theirs. A finished lane starts on the next id.
+     *
+     * @param ids numeric bid ids
+     * @param count number of ids
+     * @param out count entries, set to the bid found or nullptr
+     */
+    void SearchBatch(const std::uint32_t* ids, std::size_t count, const Bid** out) const;
+    std::size_t Size() const;
+    std::size_t Height() const;
+    double AverageDepth() const;
+    const NodePool<Node>& Nodes() const { return nodes; }
+};
+
+#endif /*!_BINARYSEARCHTREE_HPP_*/
@@ -1,8 +1,12 @@
 #ifndef     _CSVPARSER_HPP_
 # define    _CSVPARSER_HPP_
 
+# include <cctype>
+# include <charconv>
 # include <stdexcept>
 # include <string>
+# include <system_error>
+# include <type_traits>
 # include <vector>
 # include <list>
 # include <sstream>
@@ -34,6 +38,17 @@ namespace csv
     		const std::vector<std::string> _header;
     		std::vector<std::string> _values;
 
+            // numbers from_chars can read without building a stringstream
+            template<typename T>
+            static constexpr bool isPlainNumber(void)
+            {
+                return std::is_floating_point<T>::value
+                    || (std::is_integral<T>::value && sizeof(T) > 1
+                        && !std::is_same<T, wchar_t>::value
+                        && !std::is_same<T, char16_t>::value
+                        && !std::is_same<T, char32_t>::value);
+            }
+
         public:
 
             template<typename T>
@@ -42,6 +57,16 @@ namespace csv
                 if (pos < _values.size())
                 {
                     T res;
+                    if constexpr (isPlainNumber<T>())
+                    {
+                        // operator>> skips leading blanks, from_chars doesn't
+                        const char *first = _values[pos].data();
+                        const char *last = first + _values[pos].size();
+                        while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+                            ++first;
+                        if (std::from_chars(first, last, res).ec == std::errc())
+                            return res;
+                    }
                     std::stringstream ss;
                     ss << _values[pos];
                     ss >> res;
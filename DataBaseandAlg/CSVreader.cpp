@@ -0,0 +1,385 @@
+#include "CSVreader.hpp"
+#include "CpuFeatures.hpp"
+
+#include <cstring>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace csv
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string &path)
+      : _data(nullptr), _size(0), _file(INVALID_HANDLE_VALUE), _mapping(nullptr)
+    {
+        _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (_file == INVALID_HANDLE_VALUE)
+            throw Error(std::string("Failed to open ").append(path));
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(_file, &size))
+        {
+            CloseHandle(_file);
+            throw Error(std::string("Failed to stat ").append(path));
+        }
+        _size = static_cast<std::size_t>(size.QuadPart);
+        if (_size == 0)
+            return;
+
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping != nullptr)
+            _data = static_cast<const char *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr)
+        {
+            if (_mapping != nullptr)
+                CloseHandle(_mapping);
+            CloseHandle(_file);
+            throw Error(std::string("Failed to map ").append(path));
+        }
+    }
+
+    MappedFile::~MappedFile(void)
+    {
+        if (_data != nullptr)
+            UnmapViewOfFile(_data);
+        if (_mapping != nullptr)
+            CloseHandle(_mapping);
+        if (_file != INVALID_HANDLE_VALUE)
+            CloseHandle(_file);
+    }
+#else
+    MappedFile::MappedFile(const std::string &path)
+      : _data(nullptr), _size(0), _fd(-1)
+    {
+        _fd = open(path.c_str(), O_RDONLY);
+        if (_fd < 0)
+            throw Error(std::string("Failed to open ").append(path));
+
+        struct stat st;
+        if (fstat(_fd, &st) != 0)
+        {
+            close(_fd);
+            throw Error(std::string("Failed to stat ").append(path));
+        }
+        _size = static_cast<std::size_t>(st.st_size);
+        if (_size == 0)
+            return;
+
+        void *addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            close(_fd);
+            throw Error(std::string("Failed to map ").append(path));
+        }
+        // the whole file is read front to back exactly once
+        madvise(addr, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(addr);
+    }
+
+    MappedFile::~MappedFile(void)
+    {
+        if (_data != nullptr)
+            munmap(const_cast<char *>(_data), _size);
+        if (_fd >= 0)
+            close(_fd);
+    }
+#endif
+
+    const char *parseRecord(const char *p, const char *end, char sep,
+                            std::vector<std::string_view> &fields)
+    {
+        bool quoted = false;
+        const char *tokenStart = p;
+
+        fields.clear();
+        for (; p != end; ++p)
+        {
+            const char c = *p;
+            if (c == '"')
+                quoted = !quoted;
+            else if (!quoted)
+            {
+                if (c == sep)
+                {
+                    fields.emplace_back(tokenStart, p - tokenStart);
+                    tokenStart = p + 1;
+                }
+                else if (c == '\n')
+                    break;
+            }
+        }
+
+        // drop the '\r' of a CRLF line ending
+        const char *tokenEnd = p;
+        if (tokenEnd != tokenStart && tokenEnd[-1] == '\r')
+            --tokenEnd;
+        fields.emplace_back(tokenStart, tokenEnd - tokenStart);
+
+        return (p == end) ? end : p + 1;
+    }
+
+    namespace
+    {
+        struct BlockMasks
+        {
+            std::uint64_t quote;
+            std::uint64_t sep;
+            std::uint64_t newline;
+        };
+
+        const std::size_t BLOCK_SIZE = 64;
+
+        /**
+         * Bit i of the result is the XOR of bits 0..i of x, i.e. set for
+         * every byte between an opening and a closing quote
+         */
+        inline std::uint64_t prefixXor(std::uint64_t x)
+        {
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
+
+#ifdef HAVE_X86
+        BlockMasks classifySse2(const char *p, char sep)
+        {
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i delim = _mm_set1_epi8(sep);
+            const __m128i newline = _mm_set1_epi8('\n');
+            BlockMasks m = { 0, 0, 0 };
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+                const int shift = 16 * i;
+                m.quote |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+                m.sep |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, delim)))) << shift;
+                m.newline |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)))) << shift;
+            }
+            return m;
+        }
+
+        TARGET_AVX2 BlockMasks classifyAvx2(const char *p, char sep)
+        {
+            const __m256i quote = _mm256_set1_epi8('"');
+            const __m256i delim = _mm256_set1_epi8(sep);
+            const __m256i newline = _mm256_set1_epi8('\n');
+            BlockMasks m = { 0, 0, 0 };
+
+            for (int i = 0; i < 2; ++i)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * i));
+                const int shift = 32 * i;
+                m.quote |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+                m.sep |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, delim)))) << shift;
+                m.newline |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)))) << shift;
+            }
+            return m;
+        }
+#endif
+    }
+
+    ScanMode bestScanMode(void)
+    {
+#ifdef HAVE_X86
+        static const ScanMode best = cpuHasAvx2() ? eAVX2 : eSSE2;
+        return best;
+#else
+        return eSCALAR;
+#endif
+    }
+
+    bool scanModeSupported(ScanMode mode)
+    {
+        switch (mode)
+        {
+        case eAUTO:
+        case eSCALAR:
+            return true;
+        case eSSE2:
+            return bestScanMode() == eSSE2 || bestScanMode() == eAVX2;
+        case eAVX2:
+            return bestScanMode() == eAVX2;
+        }
+        return false;
+    }
+
+    const char *scanModeName(ScanMode mode)
+    {
+        switch (mode)
+        {
+        case eAUTO:
+            return "auto";
+        case eSCALAR:
+            return "scalar";
+        case eSSE2:
+            return "SSE2";
+        case eAVX2:
+            return "AVX2";
+        }
+        return "unknown";
+    }
+
+    Reader::Reader(std::string_view buffer, char sep, ScanMode mode)
+      : _begin(buffer.data()), _pos(buffer.data()),
+        _end(buffer.data() + buffer.size()), _sep(sep), _mode(mode),
+        _blockBase(0), _nextBlock(0), _bits(0), _inQuote(0)
+    {
+        if (_mode == eAUTO)
+            _mode = bestScanMode();
+        else if (!scanModeSupported(_mode))
+            _mode = eSCALAR;
+    }
+
+    bool Reader::next(std::vector<std::string_view> &fields)
+    {
+        if (_mode != eSCALAR)
+            return nextIndexed(fields);
+
+        // skip blank lines
+        while (_pos != _end && (*_pos == '\n' || *_pos == '\r'))
+            ++_pos;
+        if (_pos == _end)
+            return false;
+
+        _pos = parseRecord(_pos, _end, _sep, fields);
+        return true;
+    }
+
+    /**
+     * Classify the next 64 bytes and keep the separators and newlines
+     * that are outside quotes. The tail is copied into a zero-padded
+     * block so the vector loads never read past the buffer.
+     */
+    void Reader::loadBlock(void)
+    {
+        const std::size_t size = _end - _begin;
+        const std::size_t remaining = size - _nextBlock;
+        const char *src = _begin + _nextBlock;
+        char tail[BLOCK_SIZE];
+        BlockMasks m;
+
+        if (remaining < BLOCK_SIZE)
+        {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, src, remaining);
+            src = tail;
+        }
+#ifdef HAVE_X86
+        if (_mode == eAVX2)
+            m = classifyAvx2(src, _sep);
+        else
+            m = classifySse2(src, _sep);
+#else
+        m = BlockMasks();
+#endif
+
+        const std::uint64_t inside = prefixXor(m.quote) ^ _inQuote;
+        _inQuote = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+        _bits = (m.sep | m.newline) & ~inside;
+        _blockBase = _nextBlock;
+        _nextBlock += BLOCK_SIZE;
+    }
+
+    bool Reader::nextIndexed(std::vector<std::string_view> &fields)
+    {
+        // skip blank lines; their newline bits are dropped below
+        while (_pos != _end && (*_pos == '\n' || *_pos == '\r'))
+            ++_pos;
+        if (_pos == _end)
+            return false;
+
+        const std::size_t size = _end - _begin;
+        const char *tokenStart = _pos;
+        const char *tokenEnd;
+
+        fields.clear();
+        for (;;)
+        {
+            while (_bits == 0)
+            {
+                if (_nextBlock >= size)
+                {
+                    // last record without a trailing newline
+                    tokenEnd = _end;
+                    if (tokenEnd != tokenStart && tokenEnd[-1] == '\r')
+                        --tokenEnd;
+                    fields.emplace_back(tokenStart, tokenEnd - tokenStart);
+                    _pos = _end;
+                    return true;
+                }
+                loadBlock();
+            }
+
+            const char *p = _begin + _blockBase + trailingZeros64(_bits);
+            _bits &= _bits - 1;
+            if (p < _pos)
+                continue;
+
+            if (*p == _sep)
+            {
+                fields.emplace_back(tokenStart, p - tokenStart);
+                tokenStart = p + 1;
+            }
+            else
+            {
+                tokenEnd = p;
+                if (tokenEnd != tokenStart && tokenEnd[-1] == '\r')
+                    --tokenEnd;
+                fields.emplace_back(tokenStart, tokenEnd - tokenStart);
+                _pos = p + 1;
+                return true;
+            }
+        }
+    }
+
+    std::string unquote(std::string_view field)
+    {
+        if (field.size() < 2 || field.front() != '"' || field.back() != '"')
+            return std::string(field);
+
+        std::string res;
+        res.reserve(field.size() - 2);
+        for (std::size_t i = 1; i + 1 < field.size(); ++i)
+        {
+            res.push_back(field[i]);
+            // "" inside a quoted field is one literal quote
+            if (field[i] == '"' && field[i + 1] == '"' && i + 2 < field.size())
+                ++i;
+        }
+        return res;
+    }
+
+    std::string_view unquote(std::string_view field, std::string &scratch)
+    {
+        if (field.size() < 2 || field.front() != '"' || field.back() != '"')
+            return field;
+
+        std::string_view inner = field.substr(1, field.size() - 2);
+        if (inner.find('"') == std::string_view::npos)
+            return inner;
+
+        scratch.clear();
+        for (std::size_t i = 0; i < inner.size(); ++i)
+        {
+            scratch.push_back(inner[i]);
+            if (inner[i] == '"' && i + 1 < inner.size() && inner[i + 1] == '"')
+                ++i;
+        }
+        return scratch;
+    }
+}
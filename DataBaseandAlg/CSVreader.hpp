@@ -0,0 +1,110 @@
+#ifndef     _CSVREADER_HPP_
+# define    _CSVREADER_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <vector>
+# include "CSVparser.hpp"
+
+namespace csv
+{
+    /**
+     * Read-only memory mapping of a whole file. The mapping lives as long
+     * as the object, so any string_view handed out by a Reader over it
+     * must not outlive it.
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &);
+        ~MappedFile(void);
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+    public:
+        const char *data(void) const { return _data; }
+        std::size_t size(void) const { return _size; }
+        std::string_view view(void) const { return std::string_view(_data, _size); }
+
+    private:
+        const char *_data;
+        std::size_t _size;
+# ifdef _WIN32
+        void *_file;
+        void *_mapping;
+# else
+        int _fd;
+# endif
+    };
+
+    /**
+     * Split one record starting at p into raw field views.
+     * Fields keep their surrounding quotes exactly like csv::Row does;
+     * a separator or newline inside quotes does not end the field.
+     *
+     * @return pointer just past the record's terminating newline
+     */
+    const char *parseRecord(const char *p, const char *end, char sep,
+                            std::vector<std::string_view> &fields);
+
+    /**
+     * How a Reader finds field boundaries. eSCALAR walks byte by byte;
+     * eSSE2 and eAVX2 classify 64 bytes at a time into quote, separator
+     * and newline bitmaps and walk the set bits. eAUTO picks the widest
+     * one the CPU supports.
+     */
+    enum ScanMode {
+        eAUTO = 0,
+        eSCALAR = 1,
+        eSSE2 = 2,
+        eAVX2 = 3
+    };
+
+    ScanMode bestScanMode(void);
+    bool scanModeSupported(ScanMode);
+    const char *scanModeName(ScanMode);
+
+    /**
+     * Streaming record reader over an in-memory buffer (usually a
+     * MappedFile). Blank lines are skipped the same way csv::Parser
+     * skips them. Every ScanMode yields the same fields; unlike
+     * csv::Parser, a newline inside quotes stays part of its field.
+     */
+    class Reader
+    {
+    public:
+        explicit Reader(std::string_view buffer, char sep = ',', ScanMode mode = eAUTO);
+
+    public:
+        bool next(std::vector<std::string_view> &fields);
+        std::size_t offset(void) const { return _pos - _begin; }
+        ScanMode mode(void) const { return _mode; }
+
+    private:
+        bool nextIndexed(std::vector<std::string_view> &fields);
+        void loadBlock(void);
+
+    private:
+        const char *_begin;
+        const char *_pos;
+        const char *_end;
+        const char _sep;
+        ScanMode _mode;
+
+        // bitmap mode state: structural bits of the 64-byte block at _blockBase
+        std::size_t _blockBase;
+        std::size_t _nextBlock;
+        std::uint64_t _bits;
+        std::uint64_t _inQuote;
+    };
+
+    // Materialize a raw field, removing RFC-4180 quoting ("a ""b""" -> a "b")
+    std::string unquote(std::string_view);
+
+    // Same, but only copies (into scratch) when the field has "" escapes
+    std::string_view unquote(std::string_view, std::string &scratch);
+}
+
+#endif /*!_CSVREADER_HPP_*/
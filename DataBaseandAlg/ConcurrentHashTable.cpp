@@ -0,0 +1,102 @@
+#include <mutex>
+#include <utility>
+#include "ConcurrentHashTable.hpp"
+using namespace std;
+
+/**
+ * Constructor
+ *
+ * @param shards number of independently locked tables, rounded up to a
+ *               power of two
+ */
+ConcurrentHashTable::ConcurrentHashTable(unsigned shards) {
+    shardCount = 1;
+    shardBits = 0;
+    while (shardCount < shards) {
+        shardCount *= 2;
+        ++shardBits;
+    }
+    this->shards.reset(new Shard[shardCount]);
+}
+
+/**
+ * Destructor
+ */
+ConcurrentHashTable::~ConcurrentHashTable() {
+}
+
+/**
+ * Fibonacci hashing on the top bits; the shard's own table indexes with
+ * the low bits of a different hash, so the two choices don't correlate
+ */
+ConcurrentHashTable::Shard& ConcurrentHashTable::shardFor(uint32_t key) const {
+    if (shardBits == 0) {
+        return shards[0];
+    }
+    return shards[(key * 2654435769u) >> (32 - shardBits)];
+}
+
+/**
+ * Insert a bid, replacing any bid with the same id
+ *
+ * @return false if the bid id is not a number
+ */
+bool ConcurrentHashTable::Insert(Bid bid) {
+    uint32_t key;
+    if (!bidIdToKey(bid.bidId, key)) {
+        return false;
+    }
+    Shard& shard = shardFor(key);
+    unique_lock<shared_mutex> guard(shard.lock);
+    return shard.table.Insert(move(bid));
+}
+
+/**
+ * Print all bids, one shard at a time
+ */
+void ConcurrentHashTable::PrintAll() const {
+    for (unsigned i = 0; i < shardCount; ++i) {
+        shared_lock<shared_mutex> guard(shards[i].lock);
+        shards[i].table.PrintAll();
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @return false if there was no bid with that id
+ */
+bool ConcurrentHashTable::Remove(string bidId) {
+    uint32_t key;
+    if (!bidIdToKey(bidId, key)) {
+        return false;
+    }
+    Shard& shard = shardFor(key);
+    unique_lock<shared_mutex> guard(shard.lock);
+    return shard.table.Remove(move(bidId));
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @return a copy of the bid, or an empty Bid if there is none
+ */
+Bid ConcurrentHashTable::Search(string bidId) const {
+    uint32_t key;
+    if (!bidIdToKey(bidId, key)) {
+        return Bid();
+    }
+    const Shard& shard = shardFor(key);
+    shared_lock<shared_mutex> guard(shard.lock);
+    const Bid* bid = shard.table.Find(key);
+    return bid == nullptr ? Bid() : *bid;
+}
+
+size_t ConcurrentHashTable::Size() const {
+    size_t size = 0;
+    for (unsigned i = 0; i < shardCount; ++i) {
+        shared_lock<shared_mutex> guard(shards[i].lock);
+        size += shards[i].table.Size();
+    }
+    return size;
+}
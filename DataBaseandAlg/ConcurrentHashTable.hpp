@@ -0,0 +1,61 @@
+#ifndef     _CONCURRENTHASHTABLE_HPP_
+# define    _CONCURRENTHASHTABLE_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <memory>
+# include <shared_mutex>
+# include <string>
+# include "Bid.hpp"
+# include "RobinHoodHashTable.hpp"
+
+/**
+ * Hash table of bids that any number of threads can use at once. Keys
+ * are spread over a power-of-two number of shards, each one a
+ * RobinHoodHashTable behind its own reader-writer lock:
+ *
+ *  - Search takes its shard's lock shared, so lookups never wait for
+ *    each other, and copies the bid out before letting go, so a writer
+ *    can never change it half way through the copy,
+ *  - Insert and Remove lock only their shard, so writers to different
+ *    shards and readers of other shards carry on,
+ *  - each shard sits on its own cache lines, so taking one lock doesn't
+ *    invalidate the line holding the next one.
+ *
+ * A shard rehashes incrementally under its writers' lock. Readers use
+ * the lookup that moves no slots, so a shared lock is enough for them.
+ */
+class ConcurrentHashTable {
+
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        RobinHoodHashTable table;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    unsigned shardCount;
+    unsigned shardBits;
+
+    Shard& shardFor(std::uint32_t key) const;
+
+public:
+    static const unsigned DEFAULT_SHARDS = 64;
+
+    // shards is rounded up to a power of two; 1 gives a single table-wide lock
+    explicit ConcurrentHashTable(unsigned shards = DEFAULT_SHARDS);
+    virtual ~ConcurrentHashTable();
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    bool Insert(Bid bid);
+    void PrintAll() const;
+    bool Remove(std::string bidId);
+    Bid Search(std::string bidId) const;
+
+    // bids in all shards; only exact while no other thread is writing
+    std::size_t Size() const;
+    unsigned ShardCount() const { return shardCount; }
+};
+
+#endif /*!_CONCURRENTHASHTABLE_HPP_*/
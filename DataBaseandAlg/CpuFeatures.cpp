@@ -0,0 +1,60 @@
+#include "CpuFeatures.hpp"
+
+#if defined(HAVE_X86) && !defined(_MSC_VER)
+# include <cpuid.h>
+#endif
+
+#ifdef HAVE_X86
+namespace {
+
+void cpuid(int leaf, int sub, unsigned regs[4]) {
+# ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, leaf, sub);
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned>(r[i]);
+    }
+# else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __get_cpuid_count(leaf, sub, &regs[0], &regs[1], &regs[2], &regs[3]);
+# endif
+}
+
+bool detectAvx2() {
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    if (regs[0] < 7) {
+        return false;
+    }
+
+    // the OS must save the YMM registers (OSXSAVE + AVX, then XCR0 bits 1 and 2)
+    cpuid(1, 0, regs);
+    if ((regs[2] & (1u << 27)) == 0 || (regs[2] & (1u << 28)) == 0) {
+        return false;
+    }
+# ifdef _MSC_VER
+    const unsigned long long xcr0 = _xgetbv(0);
+# else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    const unsigned long long xcr0 = (static_cast<unsigned long long>(hi) << 32) | lo;
+# endif
+    if ((xcr0 & 0x6) != 0x6) {
+        return false;
+    }
+
+    cpuid(7, 0, regs);
+    return (regs[1] & (1u << 5)) != 0;
+}
+
+}
+#endif
+
+bool cpuHasAvx2() {
+#ifdef HAVE_X86
+    static const bool has = detectAvx2();
+    return has;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,57 @@
+#ifndef     _CPUFEATURES_HPP_
+# define    _CPUFEATURES_HPP_
+
+# include <cstdint>
+
+/**
+ * Runtime CPU feature checks for the SIMD code paths. Code using AVX2
+ * intrinsics is compiled per function with TARGET_AVX2 and only called
+ * after cpuHasAvx2() said yes, so the build needs no /arch flag.
+ */
+
+# if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define HAVE_X86 1
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#   define TARGET_AVX2
+#  else
+#   define TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+# endif
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+
+// AVX2 usable: the CPU has it and the OS saves the YMM registers
+bool cpuHasAvx2();
+
+// ask for the cache line holding p ahead of a read; only a hint, p may be anything
+inline void prefetchRead(const void* p) {
+# ifdef HAVE_X86
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+# elif defined(__GNUC__)
+    __builtin_prefetch(p);
+# else
+    (void)p;
+# endif
+}
+
+// index of the lowest set bit; x must not be 0
+inline unsigned trailingZeros64(std::uint64_t x) {
+# if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return idx;
+# elif defined(_MSC_VER)
+    // 32-bit builds have only the 32-bit scan
+    unsigned long idx;
+    if (_BitScanForward(&idx, static_cast<unsigned long>(x)))
+        return idx;
+    _BitScanForward(&idx, static_cast<unsigned long>(x >> 32));
+    return idx + 32;
+# else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+# endif
+}
+
+#endif /*!_CPUFEATURES_HPP_*/
@@ -0,0 +1,108 @@
+#include <charconv>
+#include <limits>
+#include <system_error>
+#include "Currency.hpp"
+
+namespace {
+
+inline bool isFiller(char c) {
+    return c == '$' || c == ',' || c == '"' || c == ' ' || c == '\t';
+}
+
+}
+
+bool parseCurrency(std::string_view field, double& value) {
+    // a money field never needs more than this many significant characters
+    char buf[64];
+    std::size_t n = 0;
+
+    value = 0.0;
+    for (char c : field) {
+        if (isFiller(c)) {
+            continue;
+        }
+        if (n == sizeof(buf)) {
+            return false;
+        }
+        buf[n++] = c;
+    }
+    if (n == 0) {
+        return false;
+    }
+
+    std::from_chars_result res = std::from_chars(buf, buf + n, value);
+    // a number with something after it, like 12x, isn't one either
+    if (res.ec != std::errc() || res.ptr != buf + n) {
+        value = 0.0;
+        return false;
+    }
+    return true;
+}
+
+bool parseCents(std::string_view field, std::int64_t& cents) {
+    const std::int64_t maxWhole = std::numeric_limits<std::int64_t>::max() / 100 - 1;
+    std::int64_t whole = 0;
+    std::int64_t fraction = 0;
+    int fractionDigits = 0;
+    int roundDigit = -1;
+    bool negative = false;
+    bool inFraction = false;
+    bool sawDigit = false;
+
+    cents = 0;
+    for (char c : field) {
+        if (isFiller(c)) {
+            continue;
+        }
+        if (c == '-' && !negative && !sawDigit && !inFraction) {
+            negative = true;
+        }
+        else if (c == '.' && !inFraction) {
+            inFraction = true;
+        }
+        else if (c >= '0' && c <= '9') {
+            const int digit = c - '0';
+            sawDigit = true;
+            if (!inFraction) {
+                if (whole > (maxWhole - digit) / 10) {
+                    return false;
+                }
+                whole = whole * 10 + digit;
+            }
+            else if (fractionDigits < 2) {
+                fraction = fraction * 10 + digit;
+                ++fractionDigits;
+            }
+            else if (roundDigit < 0) {
+                roundDigit = digit;
+            }
+        }
+        else {
+            return false;
+        }
+    }
+    if (!sawDigit) {
+        return false;
+    }
+
+    if (fractionDigits == 1) {
+        fraction *= 10;
+    }
+    cents = whole * 100 + fraction + (roundDigit >= 5 ? 1 : 0);
+    if (negative) {
+        cents = -cents;
+    }
+    return true;
+}
+
+std::string formatCents(std::int64_t cents) {
+    const bool negative = cents < 0;
+    const std::uint64_t magnitude = negative ? 0 - static_cast<std::uint64_t>(cents) : cents;
+    std::string res = std::to_string(magnitude / 100);
+    const unsigned fraction = static_cast<unsigned>(magnitude % 100);
+
+    res.push_back('.');
+    res.push_back(static_cast<char>('0' + fraction / 10));
+    res.push_back(static_cast<char>('0' + fraction % 10));
+    return negative ? "-" + res : res;
+}
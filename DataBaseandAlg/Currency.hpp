@@ -0,0 +1,25 @@
+#ifndef     _CURRENCY_HPP_
+# define    _CURRENCY_HPP_
+
+# include <cstdint>
+# include <string>
+# include <string_view>
+
+/**
+ * Allocation-free parsing of money fields such as $1,234.56, "$-132.68"
+ * or $27.00 straight from the raw CSV field. Quotes, '$', thousands
+ * separators and blanks are skipped; a '-' may come before or after
+ * the '$'. Both return false (and a zero value) for an empty field or
+ * one that isn't a number.
+ */
+
+// parse into a double with std::from_chars (locale independent)
+bool parseCurrency(std::string_view field, double& value);
+
+// parse into whole cents, rounding half away from zero past two decimals
+bool parseCents(std::string_view field, std::int64_t& cents);
+
+// render cents as dollars, e.g. -13268 -> "-132.68"
+std::string formatCents(std::int64_t cents);
+
+#endif /*!_CURRENCY_HPP_*/
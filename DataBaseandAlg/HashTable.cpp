@@ -0,0 +1,143 @@
+#include <cstdlib>
+#include "HashTable.hpp"
+#include "LatencyStats.hpp"
+using namespace std;
+
+/**
+* Default constructor
+*/
+HashTable::HashTable() {
+    // Initialize the structures used to hold bids
+    myNodes.resize(setSize);
+}
+
+HashTable::HashTable(unsigned size) {
+    this->setSize = size;
+    myNodes.resize(setSize);
+}
+
+/**
+* Destructor
+*/
+HashTable::~HashTable() {
+    // Implement logic to free storage when class is destroyed
+    myNodes.erase(myNodes.begin());
+}
+
+/**
+* Calculate the hash value of a given key.
+* Note that key is specifically defined as
+* unsigned int to prevent undefined results
+* of a negative list index.
+*
+* @param key The key to hash
+* @return The calculated hash
+*/
+unsigned int HashTable::hash(int key) {
+    // Implement logic to calculate a hash value
+    return key % setSize;
+}
+
+/**
+* Insert a bid
+*
+* @param bid The bid to insert
+*/
+void HashTable::Insert(Bid bid) {
+    LatencyProbe probe(eLATENCY_HASH_TABLE, eLATENCY_INSERT);
+    // Implement logic to insert a bid
+    unsigned key = hash(atoi(bid.bidId.c_str()));
+
+    // search for node with the key value
+
+    Node* prevNode = &(myNodes.at(key));
+
+    if (prevNode == nullptr) {
+        Node* nextNode = new Node(move(bid), key);
+        myNodes.insert(myNodes.begin() + key, (*nextNode));
+    }
+    else {
+        // if node is found
+        if (prevNode->key == UINT_MAX) {
+            prevNode->key = key;
+            prevNode->bid = move(bid);
+            prevNode->nextNodePtr = nullptr;
+        }
+        else {
+            // if not found, find the next node available
+            while (prevNode->nextNodePtr != nullptr) {
+                prevNode = prevNode->nextNodePtr;
+            }
+        }
+    }
+}
+
+/**
+* Print all bids
+*/
+void HashTable::PrintAll() {
+    // Implement logic to print all bids
+    for (unsigned int i = 0; i < myNodes.size(); ++i) {
+        displayBid(myNodes[i].bid);
+    }
+}
+
+/**
+* Remove a bid
+*
+* @param bidId The bid id to search for
+*/
+void HashTable::Remove(string bidId) {
+    LatencyProbe probe(eLATENCY_HASH_TABLE, eLATENCY_REMOVE);
+    // Implement logic to remove a bid
+    unsigned key = hash(atoi(bidId.c_str()));
+    myNodes.erase(myNodes.begin() + key);
+}
+
+/**
+* Search for the specified bidId
+*
+* @param bidId The bid id to search for
+*/
+Bid HashTable::Search(string bidId) {
+    LatencyProbe probe(eLATENCY_HASH_TABLE, eLATENCY_SEARCH);
+    Bid bid;
+
+    // Implement logic to search for and return a bid
+    unsigned key = hash(atoi(bidId.c_str()));
+
+    // search for node with the key value
+
+    Node* node = &(myNodes.at(key));
+
+    // search for node using key
+
+    // if node is found by given key
+    if (node != nullptr && node->key != UINT_MAX
+        && node->bid.bidId.compare(bidId) == 0) {
+        probe.Work(1);
+        return node->bid;
+    }
+
+    // if there is no node with the key value
+    if (node == nullptr || node->key == UINT_MAX) {
+        return bid;
+    }
+
+    // traverse list to look for a mat h
+    size_t probes = 0;
+    while (node != nullptr) {
+        ++probes;
+        if (node->key != UINT_MAX && node->bid.bidId.compare(bidId) == 0) {
+            probe.Work(probes);
+            return node->bid;
+        }
+        node = node->nextNodePtr;
+    }
+
+    return bid;
+}
+
+size_t HashTable::MemoryBytes() const {
+    return myNodes.capacity() * sizeof(Node);
+}
@@ -0,0 +1,65 @@
+#ifndef     _HASHTABLE_HPP_
+# define    _HASHTABLE_HPP_
+
+# include <climits>
+# include <cstddef>
+# include <string>
+# include <utility>
+# include <vector>
+# include "Bid.hpp"
+
+// number of buckets a default constructed HashTable starts with
+const unsigned int DEFAULT_SIZE = 20000;
+
+//============================================================================
+// Hash Table class definition
+//============================================================================
+
+/**
+* Define a class containing data members and methods to
+* implement a hash table with chaining.
+*/
+class HashTable {
+
+private:
+    // Define structures to hold bids
+    struct Node {
+        Bid bid;
+        unsigned key;
+        Node* nextNodePtr;
+
+        // constructor
+        Node() {
+            key = UINT_MAX;
+            nextNodePtr = nullptr;
+        }
+
+        // Node initialized with a bid
+        Node(Bid myBid) : Node() {
+            bid = std::move(myBid);
+        }
+
+        Node(Bid myBid, unsigned newKey) : Node(std::move(myBid)) {
+            key = newKey;
+        }
+    };
+
+    std::vector<Node> myNodes;
+
+    unsigned setSize = DEFAULT_SIZE;
+
+    unsigned int hash(int key);
+
+public:
+    HashTable();
+    HashTable(unsigned size);
+    virtual ~HashTable();
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(std::string bidId);
+    Bid Search(std::string bidId);
+    // bytes held by the bucket array, not counting the bids' strings
+    std::size_t MemoryBytes() const;
+};
+
+#endif /*!_HASHTABLE_HPP_*/
@@ -0,0 +1,81 @@
+#include <cstring>
+#include "IndexSort.hpp"
+using namespace std;
+
+namespace {
+
+struct PrefixEntry {
+    uint64_t prefix;
+    uint32_t index;
+};
+
+inline uint64_t byteSwap(uint64_t x) {
+#ifdef _MSC_VER
+    return _byteswap_uint64(x);
+#else
+    return __builtin_bswap64(x);
+#endif
+}
+
+inline bool littleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+}
+
+uint64_t titlePrefix(string_view s) {
+    if (s.size() >= 8) {
+        uint64_t raw;
+        memcpy(&raw, s.data(), 8);
+        return littleEndian() ? byteSwap(raw) : raw;
+    }
+    uint64_t prefix = 0;
+    for (size_t k = 0; k < 8; ++k) {
+        prefix = (prefix << 8) | (k < s.size() ? static_cast<unsigned char>(s[k]) : 0);
+    }
+    return prefix;
+}
+
+vector<uint32_t> sortedIndexByTitle(const vector<Bid>& bids) {
+    vector<PrefixEntry> entries(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        entries[i].prefix = titlePrefix(bids[i].title);
+        entries[i].index = static_cast<uint32_t>(i);
+    }
+
+    pdqSort(entries.begin(), entries.end(), [&bids](const PrefixEntry& a, const PrefixEntry& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        return bids[a.index].title < bids[b.index].title;
+    });
+
+    vector<uint32_t> order(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        order[i] = entries[i].index;
+    }
+    return order;
+}
+
+void applyPermutation(vector<Bid>& bids, const vector<uint32_t>& order) {
+    vector<bool> placed(bids.size(), false);
+
+    for (size_t start = 0; start < bids.size(); ++start) {
+        if (placed[start]) {
+            continue;
+        }
+        // position j receives the bid at order[j]; follow that until the cycle closes
+        Bid held = move(bids[start]);
+        size_t j = start;
+        while (order[j] != start) {
+            bids[j] = move(bids[order[j]]);
+            placed[j] = true;
+            j = order[j];
+        }
+        bids[j] = move(held);
+        placed[j] = true;
+    }
+}
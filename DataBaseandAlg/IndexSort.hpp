@@ -0,0 +1,74 @@
+#ifndef     _INDEXSORT_HPP_
+# define    _INDEXSORT_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string_view>
+# include <vector>
+# include "Bid.hpp"
+# include "SortEngine.hpp"
+
+/**
+ * Sorting through a permutation instead of moving Bid records around.
+ * The sort works on 4-byte indexes (or 16-byte prefix/index pairs for
+ * titles); the records are then either left alone and read through a
+ * SortedBidView, or moved into place once by applyPermutation().
+ */
+
+/**
+ * Indexes of bids in ascending key order
+ *
+ * @param key extractor as for pdqSortBy
+ * @return order, with bids[order[0]] the smallest
+ */
+template <class KeyFn>
+std::vector<std::uint32_t> sortedIndexBy(const std::vector<Bid>& bids, KeyFn key) {
+    std::vector<std::uint32_t> order(bids.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<std::uint32_t>(i);
+    }
+    pdqSort(order.begin(), order.end(), [&bids, &key](std::uint32_t a, std::uint32_t b) {
+        return key(bids[a]) < key(bids[b]);
+    });
+    return order;
+}
+
+/**
+ * Title order using the first 8 title bytes as a big-endian integer, so
+ * most comparisons are one integer compare; only equal prefixes fall
+ * back to comparing the full titles.
+ *
+ * @return order, with bids[order[0]] the first title
+ */
+std::vector<std::uint32_t> sortedIndexByTitle(const std::vector<Bid>& bids);
+
+// first 8 bytes of s as a big-endian integer, zero padded
+std::uint64_t titlePrefix(std::string_view s);
+
+/**
+ * Move every bid to its sorted position, each record moving exactly
+ * once along the permutation's cycles
+ *
+ * @param order as returned by the sortedIndex functions
+ */
+void applyPermutation(std::vector<Bid>& bids, const std::vector<std::uint32_t>& order);
+
+/**
+ * Read-only sorted view over a vector it doesn't own
+ */
+class SortedBidView {
+
+private:
+    const std::vector<Bid>* bids;
+    std::vector<std::uint32_t> order;
+
+public:
+    SortedBidView(const std::vector<Bid>& source, std::vector<std::uint32_t> sortedOrder)
+        : bids(&source), order(std::move(sortedOrder)) {
+    }
+
+    std::size_t Size() const { return order.size(); }
+    const Bid& operator[](std::size_t i) const { return (*bids)[order[i]]; }
+};
+
+#endif /*!_INDEXSORT_HPP_*/
@@ -0,0 +1,125 @@
+#include <utility>
+#include "IndexedBidTable.hpp"
+using namespace std;
+
+/**
+ * Constructor
+ */
+IndexedBidTable::IndexedBidTable()
+    : byAmount(AmountLess{ &records }), byTitle(TitleLess{ &records }) {
+}
+
+/**
+ * Destructor
+ */
+IndexedBidTable::~IndexedBidTable() {
+}
+
+/**
+ * Add a record to every secondary index
+ */
+void IndexedBidTable::index(uint32_t record) {
+    byAmount.Insert(record);
+    byTitle.Insert(record);
+    filters.Add(record, records[record]);
+}
+
+/**
+ * Take a record out of every secondary index; the indexes find it through
+ * its keys, so this has to come before the record changes
+ */
+void IndexedBidTable::unindex(uint32_t record) {
+    byAmount.Remove(record);
+    byTitle.Remove(record);
+    filters.Remove(record, records[record]);
+}
+
+vector<const Bid*> IndexedBidTable::bidsOf(const vector<uint32_t>& found) const {
+    vector<const Bid*> bids(found.size());
+    for (size_t i = 0; i < found.size(); ++i) {
+        bids[i] = &records[found[i]];
+    }
+    return bids;
+}
+
+bool IndexedBidTable::Insert(Bid bid) {
+    uint32_t key;
+    if (!bidIdToKey(bid.bidId, key)) {
+        return false;
+    }
+    uint32_t record;
+    unordered_map<uint32_t, uint32_t>::const_iterator found = byId.find(key);
+    if (found != byId.end()) {
+        record = found->second;
+        unindex(record);
+    }
+    else if (!freeRecords.empty()) {
+        record = freeRecords.back();
+        freeRecords.pop_back();
+    }
+    else {
+        record = uint32_t(records.size());
+        records.emplace_back();
+    }
+    records[record] = move(bid);
+    index(record);
+    byId[key] = record;
+    return true;
+}
+
+bool IndexedBidTable::Remove(const string& bidId) {
+    uint32_t key;
+    if (!bidIdToKey(bidId, key)) {
+        return false;
+    }
+    unordered_map<uint32_t, uint32_t>::const_iterator found = byId.find(key);
+    if (found == byId.end()) {
+        return false;
+    }
+    const uint32_t record = found->second;
+    unindex(record);
+    records[record] = Bid();
+    freeRecords.push_back(record);
+    byId.erase(found);
+    return true;
+}
+
+const Bid* IndexedBidTable::Find(const string& bidId) const {
+    uint32_t key;
+    if (!bidIdToKey(bidId, key)) {
+        return nullptr;
+    }
+    unordered_map<uint32_t, uint32_t>::const_iterator found = byId.find(key);
+    return found == byId.end() ? nullptr : &records[found->second];
+}
+
+vector<const Bid*> IndexedBidTable::Filter(const BidFilter& filter) const {
+    vector<uint32_t> found;
+    filters.Rows(filter).AppendTo(found);
+    return bidsOf(found);
+}
+
+vector<const Bid*> IndexedBidTable::InFund(const string& fund) const {
+    return Filter(BidFilter::Equals(eFILTER_FUND, fund));
+}
+
+vector<const Bid*> IndexedBidTable::AmountBetween(double low, double high) const {
+    vector<uint32_t> found;
+    byAmount.Between(low, high, found);
+    return bidsOf(found);
+}
+
+vector<const Bid*> IndexedBidTable::TitleStartsWith(string_view prefix) const {
+    vector<uint32_t> found;
+    byTitle.Between(prefix, TitlePrefix{ prefix }, found);
+    return bidsOf(found);
+}
+
+void IndexedBidTable::Clear() {
+    byAmount.Clear();
+    byTitle.Clear();
+    byId.clear();
+    records.clear();
+    freeRecords.clear();
+    filters.Clear();
+}
@@ -0,0 +1,205 @@
+#ifndef     _INDEXEDBIDTABLE_HPP_
+# define    _INDEXEDBIDTABLE_HPP_
+
+# include <algorithm>
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <unordered_map>
+# include <vector>
+# include "Bid.hpp"
+# include "BidBitmapIndex.hpp"
+# include "BidFilter.hpp"
+
+/**
+ * Record numbers kept in the order Less gives them, in sorted blocks of
+ * at most MAX_BLOCK: a two-level B-tree. Finding a record is a binary
+ * search over the blocks' last entries and then one within a block, and
+ * a range comes out as runs of contiguous record numbers, where a
+ * node-per-entry tree would miss the cache on every step.
+ *
+ * Less compares two record numbers, a record number with a Key for the
+ * low end of a range, and a High with a record number for the top end.
+ */
+template <typename Less>
+class RecordIndex {
+    static const std::size_t MAX_BLOCK = 1024;
+
+    Less less;
+    std::vector<std::vector<std::uint32_t>> blocks;
+
+    // the first block whose last entry is not less than key
+    template <typename Key>
+    std::size_t blockFor(const Key& key) const {
+        std::size_t low = 0, high = blocks.size();
+        while (low < high) {
+            const std::size_t mid = low + (high - low) / 2;
+            if (less(blocks[mid].back(), key)) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+public:
+    explicit RecordIndex(Less less) : less(less) {}
+
+    void Insert(std::uint32_t record) {
+        if (blocks.empty()) {
+            blocks.emplace_back(1, record);
+            return;
+        }
+        const std::size_t b = std::min(blockFor(record), blocks.size() - 1);
+        std::vector<std::uint32_t>& block = blocks[b];
+        block.insert(std::lower_bound(block.begin(), block.end(), record, less), record);
+        if (block.size() > MAX_BLOCK) {
+            std::vector<std::uint32_t> upper(block.begin() + MAX_BLOCK / 2, block.end());
+            block.resize(MAX_BLOCK / 2);
+            blocks.insert(blocks.begin() + b + 1, std::move(upper));
+        }
+    }
+
+    void Remove(std::uint32_t record) {
+        const std::size_t b = blockFor(record);
+        if (b == blocks.size()) {
+            return;
+        }
+        std::vector<std::uint32_t>& block = blocks[b];
+        std::vector<std::uint32_t>::iterator it = std::lower_bound(block.begin(), block.end(), record, less);
+        if (it != block.end() && *it == record) {
+            block.erase(it);
+            if (block.empty()) {
+                blocks.erase(blocks.begin() + b);
+            }
+        }
+    }
+
+    // append every record from the first not less than low to the last not above high
+    template <typename Key, typename High>
+    void Between(const Key& low, const High& high, std::vector<std::uint32_t>& out) const {
+        const std::size_t start = blockFor(low);
+        for (std::size_t b = start; b < blocks.size(); ++b) {
+            const std::vector<std::uint32_t>& block = blocks[b];
+            std::vector<std::uint32_t>::const_iterator first = b == start
+                ? std::lower_bound(block.begin(), block.end(), low, less) : block.begin();
+            std::vector<std::uint32_t>::const_iterator last = std::upper_bound(first, block.end(), high, less);
+            out.insert(out.end(), first, last);
+            if (last != block.end()) {
+                break;
+            }
+        }
+    }
+
+    void Clear() { blocks.clear(); }
+};
+
+/**
+ * Bids keyed on their numeric id, with secondary indexes kept up to date
+ * by every Insert and Remove, so questions that aren't about the id don't
+ * need a scan:
+ *
+ *  - amount: a RecordIndex by (amount, record), for range queries,
+ *  - fund, department and pay status: a BidBitmapIndex over record
+ *    numbers, for filters combining them,
+ *  - title: a RecordIndex by (title, record), for "starts with"
+ *    queries; prefixes are case-sensitive.
+ *
+ * The indexes hold only record numbers and compare through the records,
+ * so no key is stored twice. A removed bid's record number is reused by the
+ * next insert.
+ */
+class IndexedBidTable {
+
+private:
+    struct AmountLess {
+        const std::vector<Bid>* records;
+        bool operator()(std::uint32_t a, std::uint32_t b) const {
+            const double x = (*records)[a].amount, y = (*records)[b].amount;
+            return x != y ? x < y : a < b;
+        }
+        bool operator()(std::uint32_t a, double key) const { return (*records)[a].amount < key; }
+        bool operator()(double key, std::uint32_t b) const { return key < (*records)[b].amount; }
+    };
+
+    struct TitlePrefix {
+        std::string_view text;
+    };
+
+    struct TitleLess {
+        const std::vector<Bid>* records;
+        bool operator()(std::uint32_t a, std::uint32_t b) const {
+            const int c = (*records)[a].title.compare((*records)[b].title);
+            return c != 0 ? c < 0 : a < b;
+        }
+        bool operator()(std::uint32_t a, std::string_view key) const {
+            return std::string_view((*records)[a].title) < key;
+        }
+        // the top of a prefix range: above every title that starts with it
+        bool operator()(const TitlePrefix& prefix, std::uint32_t b) const {
+            return (*records)[b].title.compare(0, prefix.text.size(), prefix.text) > 0;
+        }
+    };
+
+    std::vector<Bid> records;
+    std::vector<std::uint32_t> freeRecords;
+    std::unordered_map<std::uint32_t, std::uint32_t> byId;
+
+    RecordIndex<AmountLess> byAmount;
+    RecordIndex<TitleLess> byTitle;
+    BidBitmapIndex filters;
+
+    void index(std::uint32_t record);
+    void unindex(std::uint32_t record);
+    std::vector<const Bid*> bidsOf(const std::vector<std::uint32_t>& found) const;
+
+public:
+    IndexedBidTable();
+    virtual ~IndexedBidTable();
+    IndexedBidTable(const IndexedBidTable&) = delete;
+    IndexedBidTable& operator=(const IndexedBidTable&) = delete;
+
+    /**
+     * Insert a bid, replacing any bid with the same id
+     *
+     * @return false if the bid id is not a number
+     */
+    bool Insert(Bid bid);
+
+    // @return false if there was no bid with that id
+    bool Remove(const std::string& bidId);
+
+    // the bid with that id, or nullptr
+    const Bid* Find(const std::string& bidId) const;
+
+    // every bid the filter matches, in record order
+    std::vector<const Bid*> Filter(const BidFilter& filter) const;
+
+    // every bid in the fund, in record order
+    std::vector<const Bid*> InFund(const std::string& fund) const;
+
+    // every bid with low <= amount <= high, lowest amount first
+    std::vector<const Bid*> AmountBetween(double low, double high) const;
+
+    // every bid whose title starts with prefix, in title order
+    std::vector<const Bid*> TitleStartsWith(std::string_view prefix) const;
+
+    // visit every bid without an index, as a full scan would
+    template <typename Visit>
+    void ForEach(Visit visit) const {
+        for (const Bid& bid : records) {
+            if (!bid.bidId.empty()) {
+                visit(bid);
+            }
+        }
+    }
+
+    void Clear();
+    std::size_t Size() const { return byId.size(); }
+    const BidBitmapIndex& Filters() const { return filters; }
+};
+
+#endif /*!_INDEXEDBIDTABLE_HPP_*/
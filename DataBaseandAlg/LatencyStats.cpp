@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include "LatencyStats.hpp"
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+using namespace std;
+
+namespace latency {
+    atomic<bool> recording(false);
+}
+
+namespace {
+
+// 2^SUB_BITS buckets per power of two
+const unsigned SUB_BITS = 5;
+const uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BITS;
+// values from 2^MAX_BITS ns up share the last bucket
+const unsigned MAX_BITS = 40;
+const size_t BUCKETS = size_t(SUB_BUCKETS + (MAX_BITS - SUB_BITS) * SUB_BUCKETS);
+
+const char* const STRUCTURE_NAMES[] = { "BinarySearchTree", "AvlTree", "HashTable", "RobinHoodHashTable" };
+const char* const OPERATION_NAMES[] = { "Search", "Insert", "Remove" };
+
+unsigned highestBit(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return idx;
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if (_BitScanReverse(&idx, static_cast<unsigned long>(x >> 32)))
+        return idx + 32;
+    _BitScanReverse(&idx, static_cast<unsigned long>(x));
+    return idx;
+#else
+    return 63 - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+size_t bucketOf(uint64_t ns) {
+    if (ns < SUB_BUCKETS) {
+        return size_t(ns);
+    }
+    const unsigned e = highestBit(ns);
+    if (e >= MAX_BITS) {
+        return BUCKETS - 1;
+    }
+    return size_t(SUB_BUCKETS + (e - SUB_BITS) * SUB_BUCKETS + (ns >> (e - SUB_BITS)) - SUB_BUCKETS);
+}
+
+// the largest value that falls in bucket b
+uint64_t bucketTop(size_t b) {
+    if (b < SUB_BUCKETS) {
+        return b;
+    }
+    const unsigned e = SUB_BITS + unsigned((b - SUB_BUCKETS) / SUB_BUCKETS);
+    const uint64_t sub = (b - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + sub + 1) << (e - SUB_BITS)) - 1;
+}
+
+// only the owning thread writes, so a plain load and store can't lose a count
+void bump(atomic<uint64_t>& counter, uint64_t by) {
+    counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed);
+}
+
+struct Histogram {
+    atomic<uint64_t> counts[BUCKETS];
+    atomic<uint64_t> totalNs;
+    atomic<uint64_t> maxNs;
+    atomic<uint64_t> work;
+    atomic<uint64_t> workCount;
+
+    Histogram() { Clear(); }
+
+    void Clear() {
+        for (atomic<uint64_t>& count : counts) {
+            count.store(0, memory_order_relaxed);
+        }
+        totalNs.store(0, memory_order_relaxed);
+        maxNs.store(0, memory_order_relaxed);
+        work.store(0, memory_order_relaxed);
+        workCount.store(0, memory_order_relaxed);
+    }
+};
+
+// one thread's histograms; kept after the thread ends so its calls still count
+struct ThreadHistograms {
+    Histogram cells[eLATENCY_STRUCTURES][eLATENCY_OPERATIONS];
+};
+
+mutex registryLock;
+
+vector<unique_ptr<ThreadHistograms>>& registry() {
+    static vector<unique_ptr<ThreadHistograms>> threads;
+    return threads;
+}
+
+ThreadHistograms& threadHistograms() {
+    thread_local ThreadHistograms* mine = nullptr;
+    if (mine == nullptr) {
+        unique_ptr<ThreadHistograms> fresh(new ThreadHistograms());
+        mine = fresh.get();
+        lock_guard<mutex> guard(registryLock);
+        registry().push_back(move(fresh));
+    }
+    return *mine;
+}
+
+// nearest rank, reported as the top of its bucket but never above the true max
+double percentile(const vector<uint64_t>& counts, uint64_t total, uint64_t maxNs, double q) {
+    const uint64_t rank = max<uint64_t>(1, uint64_t(ceil(q * double(total))));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < counts.size(); ++b) {
+        seen += counts[b];
+        if (seen >= rank) {
+            return double(min(bucketTop(b), maxNs));
+        }
+    }
+    return double(maxNs);
+}
+}
+
+void setLatencyRecording(bool on) {
+    latency::recording.store(on, memory_order_relaxed);
+}
+
+void recordLatency(LatencyStructure structure, LatencyOperation operation,
+                   uint64_t nanoseconds, uint64_t work, bool hasWork) {
+    Histogram& h = threadHistograms().cells[structure][operation];
+    bump(h.counts[bucketOf(nanoseconds)], 1);
+    bump(h.totalNs, nanoseconds);
+    if (nanoseconds > h.maxNs.load(memory_order_relaxed)) {
+        h.maxNs.store(nanoseconds, memory_order_relaxed);
+    }
+    if (hasWork) {
+        bump(h.work, work);
+        bump(h.workCount, 1);
+    }
+}
+
+vector<LatencySummary> latencySummaries() {
+    vector<LatencySummary> summaries;
+    vector<uint64_t> counts(BUCKETS);
+    lock_guard<mutex> guard(registryLock);
+
+    for (int s = 0; s < eLATENCY_STRUCTURES; ++s) {
+        for (int o = 0; o < eLATENCY_OPERATIONS; ++o) {
+            fill(counts.begin(), counts.end(), 0);
+            uint64_t total = 0, totalNs = 0, maxNs = 0, work = 0, workCount = 0;
+            for (const unique_ptr<ThreadHistograms>& thread : registry()) {
+                const Histogram& h = thread->cells[s][o];
+                for (size_t b = 0; b < BUCKETS; ++b) {
+                    const uint64_t count = h.counts[b].load(memory_order_relaxed);
+                    counts[b] += count;
+                    total += count;
+                }
+                totalNs += h.totalNs.load(memory_order_relaxed);
+                maxNs = max(maxNs, h.maxNs.load(memory_order_relaxed));
+                work += h.work.load(memory_order_relaxed);
+                workCount += h.workCount.load(memory_order_relaxed);
+            }
+            if (total == 0) {
+                continue;
+            }
+            LatencySummary summary;
+            summary.structure = LatencyStructure(s);
+            summary.operation = LatencyOperation(o);
+            summary.count = total;
+            summary.p50 = percentile(counts, total, maxNs, 0.50);
+            summary.p90 = percentile(counts, total, maxNs, 0.90);
+            summary.p99 = percentile(counts, total, maxNs, 0.99);
+            summary.p999 = percentile(counts, total, maxNs, 0.999);
+            summary.max = double(maxNs);
+            summary.mean = double(totalNs) / double(total);
+            summary.workCount = workCount;
+            summary.averageWork = workCount == 0 ? 0.0 : double(work) / double(workCount);
+            summaries.push_back(summary);
+        }
+    }
+    return summaries;
+}
+
+void printLatencyStats(ostream& out) {
+    const vector<LatencySummary> summaries = latencySummaries();
+    if (summaries.empty()) {
+        out << "No calls recorded" << (latencyRecording() ? "" : "; recording is off") << endl;
+        return;
+    }
+    out << "latency in ns, per call:" << endl;
+    out << left << setw(20) << "structure" << setw(8) << "op" << right << setw(10) << "count"
+        << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "p99.9"
+        << setw(12) << "max" << "  work" << endl;
+    for (const LatencySummary& s : summaries) {
+        out << left << setw(20) << latencyStructureName(s.structure) << setw(8) << latencyOperationName(s.operation)
+            << right << setw(10) << s.count << fixed << setprecision(0) << setw(10) << s.p50 << setw(10) << s.p90
+            << setw(10) << s.p99 << setw(10) << s.p999 << setw(12) << s.max;
+        if (s.workCount != 0) {
+            const bool tree = s.structure == eLATENCY_BINARY_SEARCH_TREE || s.structure == eLATENCY_AVL_TREE;
+            out << "  " << setprecision(2) << s.averageWork << (tree ? " nodes visited" : " slots probed per hit");
+        }
+        out << defaultfloat << setprecision(6) << endl;
+    }
+}
+
+void resetLatencyStats() {
+    lock_guard<mutex> guard(registryLock);
+    for (const unique_ptr<ThreadHistograms>& thread : registry()) {
+        for (auto& row : thread->cells) {
+            for (Histogram& h : row) {
+                h.Clear();
+            }
+        }
+    }
+}
+
+const char* latencyStructureName(LatencyStructure structure) {
+    return STRUCTURE_NAMES[structure];
+}
+
+const char* latencyOperationName(LatencyOperation operation) {
+    return OPERATION_NAMES[operation];
+}
@@ -6,42 +6,33 @@
 //============================================================================
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <string_view>
 #include <time.h>
 #include <vector>
+#include "AvlTree.hpp"
+#include "BPlusTree.hpp"
+#include "BenchHarness.hpp"
+#include "Benchmarks.hpp"
+#include "Bid.hpp"
+#include "BidFilter.hpp"
+#include "BidLoader.hpp"
+#include "BidSnapshot.hpp"
+#include "BinarySearchTree.hpp"
 #include "CSVparser.hpp"
+#include "Currency.hpp"
+#include "IndexSort.hpp"
+#include "IndexedBidTable.hpp"
+#include "LatencyStats.hpp"
+#include "MemoryUsage.hpp"
+#include "PerfCounters.hpp"
+#include "RobinHoodHashTable.hpp"
+#include "SalesAggregation.hpp"
+#include "SortEngine.hpp"
+#include "VectorSort.hpp"
 using namespace std;
 
-//============================================================================
-// Global definitions visible to all methods and classes
-//============================================================================
-
-const unsigned int DEFAULT_SIZE = 20000;
-// forward declarations
-double strToDouble(string str, char ch);
-
-// define a structure to hold bid information
-struct Bid {
-    string bidId; // unique identifier
-    string title;
-    string fund;
-    double amount;
-    Bid() {
-        amount = 0.0;
-    }
-};
-
-/**
- * Display the bid information to the console (std::out)
- *
- * @param bid struct containing the bid info
- */
-void displayBid(Bid bid) {
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-        << bid.fund << endl;
-    return;
-}
-
 // ********************* Start Vector Class *************************
 /**
  * Load a CSV file containing bids into a container
@@ -58,16 +49,24 @@ vector<Bid> loadBids(string csvPath) {
     // initialize the CSV Parser using the given path
     csv::Parser file = csv::Parser(csvPath);
 
+    // the same columns the mapped loader takes, e.g. Fund moves between exports
+    const vector<string> header = file.getHeader();
+    const BidLayout layout = bidLayoutFromHeader(vector<string_view>(header.begin(), header.end()));
+
     try {
         // loop to read rows of a CSV file
         for (unsigned int i = 0; i < file.rowCount(); i++) {
 
             // Create a data structure and add to the collection of bids
             Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
+            bid.bidId = file[i][layout.bidId];
+            bid.title = file[i][layout.title];
+            bid.fund = file[i][layout.fund];
+            bid.department = file[i][layout.department];
+            if (layout.payStatus != BidLayout::NO_COLUMN) {
+                bid.payStatus = file[i][layout.payStatus];
+            }
+            parseCurrency(file[i][layout.amount], bid.amount);
 
             //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
 
@@ -82,556 +81,152 @@ vector<Bid> loadBids(string csvPath) {
 }
 
 /**
- * Partition the vector of bids into two parts, low and high
+ * Load a CSV file containing bids into a vector through a memory mapping
  *
- * @param bids Address of the vector<Bid> instance to be partitioned
- * @param begin Beginning index to partition
- * @param end Ending index to partition
- */
-int partition(vector<Bid>& bids, int begin, int end)
-{
-    Bid temp;
-    bool done = false;
-
-    // sets mid to pivot
-    int mid = begin + (end - begin) / 2;
-    Bid pivot = bids.at(mid);
-    int l = begin;
-    int h = end;
-
-    while (!done)
-    {
-        // Incrament l while bids[l] < pivot
-        while (bids.at(l).title.compare(pivot.title) == -1)
-        {
-            ++l;
-        }
-        // decrement h while bids[h] > pivot
-        while (pivot.title.compare(bids.at(h).title) == -1)
-        {
-            --h;
-        }
-        // checks for 1 or 0 elements remaning, if true, return h
-        if (l >= h)
-        {
-            done = true;
-        }
-        // if false swap bids[l] with bids[h]
-        else
-        {
-            temp = bids.at(l);
-            bids.at(l) = bids.at(h);
-            bids.at(h) = temp;
-
-            ++l;
-            --h;
-        }
-    }
-    return h;
-}
-
-/**
- * Perform a quick sort on bid title
- * Average performance: O(n log(n))
- * Worst case performance O(n^2))
- *
- * @param bids address of the vector<Bid> instance to be sorted
- * @param begin the beginning index to sort on
- * @param end the ending index to sort on
- */
-void quickSort(vector<Bid>& bids, int begin, int end) {
-    // already sorted
-    if (begin >= end)
-    {
-        return;
-    }
-
-    int pivot = partition(bids, begin, end);
-
-    quickSort(bids, begin, pivot);
-    quickSort(bids, pivot + 1, end);
-
-    return;
-}
-
-/**
- * Perform a selection sort on bid title
- * Worst case performance O(n^2))
- *
- * @param bid address of the vector<Bid>
- *            instance to be sorted
- */
-void selectionSort(vector<Bid>& bids) {
-    int smallInd = 0;
-    Bid temp;
-
-    for (unsigned int i = 0; i < bids.size(); ++i)
-    {
-        smallInd = i;
-        for (unsigned int j = i + 1; j < bids.size(); ++j)
-        {
-            if (bids.at(j).title.compare(bids.at(smallInd).title) == -1)
-            {
-                smallInd = j;
-            }
-        }
-        temp = bids.at(i);
-        bids.at(i) = bids.at(smallInd);
-        bids.at(smallInd) = temp;
-    }
-}
-
-// ************************** Start Binary Tree ***************************
-struct Node {
-    Bid bid;
-    Node* left = nullptr;
-    Node* right = nullptr;
-
-    Node(Bid myBid) {
-        this->bid = myBid;
-    }
-};
-
-//============================================================================
-// Binary Search Tree class definition
-//============================================================================
-
-/**
- * Define a class containing data members and methods to
- * implement a binary search tree
- */
-class BinarySearchTree {
-
-private:
-    Node* root;
-    void addNode(Node* node, Bid bid);
-    void inOrder(Node* node);
-    Node* removeNode(Node* node, string bidId);
-    Node* minVal(Node* node);
-
-public:
-    BinarySearchTree();
-    virtual ~BinarySearchTree();
-    void InOrder();
-    void Insert(Bid bid);
-    void Remove(string bidId);
-    Bid Search(string bidId);
-};
-
-/**
- * Default constructor
- */
-BinarySearchTree::BinarySearchTree() {
-    // initialize housekeeping variables
-}
-
-/**
- * Destructor
- */
-BinarySearchTree::~BinarySearchTree() {
-    // recurse from root deleting every node
-}
-
-/**
- * Traverse the tree in order
- */
-void BinarySearchTree::InOrder() {
-}
-/**
- * Insert a bid
+ * @param csvPath the path to the CSV file to load
+ * @return a container holding all the bids read
  */
-void BinarySearchTree::Insert(Bid bid) {
-    // Implement inserting a bid into the tree
-    if (root == nullptr)
-    {
-        root = new Node(bid);
-    }
-    else
-    {
-        this->addNode(root, bid);
-    }
-}
+vector<Bid> loadBidsMapped(string csvPath) {
+    cout << "Loading CSV file " << csvPath << endl;
 
-/**
- * Remove a bid
- */
-Node* BinarySearchTree::removeNode(Node* root, string bidId)
-{
-    Node* temp;
-    if (root == NULL)
-    {
-        return root;
-    }
+    vector<Bid> bids;
 
-    if (bidId < root->bid.bidId)
-    {
-        root->left = removeNode(root->right, bidId);
-    }
-    else if (bidId > root->bid.bidId)
-    {
-        root->right = removeNode(root->right, bidId);
-    }
-    else
-    {
-        if (root->left == NULL)
-        {
-            temp = root->right;
-            free(root);
-            return temp;
-        }
-        else if (root->right == NULL)
-        {
-            Node* temp = root->left;
-            free(root);
-            return temp;
-        }
-        Node* temp = minVal(root->right);
-        root->bid.bidId = temp->bid.bidId;
-        root->right = removeNode(root->right, temp->bid.bidId);
+    try {
+        streamBids(csvPath, [&bids](Bid&& bid) {
+            bids.push_back(move(bid));
+        });
     }
-}
-
-Node* BinarySearchTree::minVal(Node* node)
-{
-    Node* current = node;
-    while (current->left != NULL)
-    {
-        current = current->left;
+    catch (csv::Error& e) {
+        std::cerr << e.what() << std::endl;
     }
-    return current;
-}
-void BinarySearchTree::Remove(string bidId) {
-    // Implement removing a bid from the tree
-    removeNode(root, bidId);
-
+    return bids;
 }
 
 /**
- * Search for a bid
+ * Print the hardware counters read around a timed action, under its
+ * "time:" lines. Where there are none, say why once and then stay quiet.
+ *
+ * @param perf the counters, just stopped
  */
-Bid BinarySearchTree::Search(string bidId) {
-    // Implement searching the tree for a bid
-
-    Bid bid;
-    Node* current = root;
-
-    while (current != nullptr)
-    {
-        if (current->bid.bidId.compare(bidId) == 0)
-        {
-            return current->bid;
-        }
-        if (bidId.compare(current->bid.bidId) < 0)
-        {
-            current = current->left;
-        }
-        else
-        {
-            current = current->right;
+void printCounters(const PerfCounters& perf) {
+    static bool explained = false;
+    if (!perf.Available()) {
+        if (!explained) {
+            cout << "counters: unavailable, " << perf.Problem() << endl;
+            explained = true;
         }
+        return;
     }
-    return bid;
+    cout << "counters: " << PerfCounters::Describe(perf.Last()) << endl;
 }
 
 /**
- * Add a bid to some node (recursive)
+ * Load a file with both the csv::Parser and the mapped loader and
+ * report time and peak memory of each
  *
- * @param node Current node in tree
- * @param bid Bid to be added
+ * @param csvPath the path to the CSV file to load
  */
-void BinarySearchTree::addNode(Node* node, Bid bid) {
-    // Implement inserting a bid into the tree
-    if (node->bid.bidId.compare(bid.bidId) > 0)
-    {
-        if (node->left == nullptr)
-        {
-            node->left = new Node(bid);
-        }
-        else
-        {
-            this->addNode(node->left, bid);
-        }
-    }
-    else
-    {
-        if (node->right == nullptr)
-        {
-            node->right = new Node(bid);
-        }
-        else
-        {
-            this->addNode(node->right, bid);
-        }
-    }
-}
-void BinarySearchTree::inOrder(Node* node) {
+void compareLoaders(string csvPath) {
+    clock_t ticks;
+    PerfCounters perf;
+    size_t rssBefore;
+    size_t bidCount;
+
+    // the mapped loader goes first so the parser's larger peak can't hide it
+    resetPeakRss();
+    rssBefore = currentRssBytes();
+    ticks = clock();
+    perf.Start();
+    bidCount = loadBidsMapped(csvPath).size();
+    ticks = clock() - ticks;
+    perf.Stop();
+    cout << "mapped loader: " << bidCount << " bids, time: " << ticks * 1.0 / CLOCKS_PER_SEC
+        << " seconds, peak RSS: +" << (peakRssBytes() - rssBefore) / 1024 << " KB" << endl;
+    printCounters(perf);
+
+    resetPeakRss();
+    rssBefore = currentRssBytes();
+    ticks = clock();
+    perf.Start();
+    bidCount = loadBids(csvPath).size();
+    ticks = clock() - ticks;
+    perf.Stop();
+    cout << "csv::Parser:   " << bidCount << " bids, time: " << ticks * 1.0 / CLOCKS_PER_SEC
+        << " seconds, peak RSS: +" << (peakRssBytes() - rssBefore) / 1024 << " KB" << endl;
+    printCounters(perf);
 }
 
 /**
- * Load a CSV file containing bids into a container
+ * Load a CSV file containing bids into a tree through a memory mapping
  *
  * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
+ * @param bst the tree to insert into
  */
-void loadBids(string csvPath, BinarySearchTree* bst) {
+void loadBidsMapped(string csvPath, BidTree* bst) {
     cout << "Loading CSV file " << csvPath << endl;
 
-    // initialize the CSV Parser using the given path
-    csv::Parser file = csv::Parser(csvPath);
-
-    // read and display header row - optional
-    /*
-    vector<string> header = file.getHeader();
-    for (auto const& c : header) {
-        cout << c << " | ";
-    }
-    */
-    cout << "" << endl;
-
     try {
-        // loop to read rows of a CSV file
-        for (unsigned int i = 0; i < file.rowCount(); i++) {
-
-            // Create a data structure and add to the collection of bids
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
-
-            // push this bid to the end
-            bst->Insert(bid);
-        }
+        streamBids(csvPath, [bst](Bid&& bid) {
+            bst->Insert(move(bid));
+        });
     }
     catch (csv::Error& e) {
         std::cerr << e.what() << std::endl;
     }
 }
-//============================================================================
-// Hash Table class definition
-//============================================================================
-
 /**
-* Define a class containing data members and methods to
-* implement a hash table with chaining.
-*/
-class HashTable {
-
-private:
-    // Define structures to hold bids
-    struct Node {
-        Bid bid;
-        unsigned key;
-        Node* nextNodePtr;
-
-        // constructor
-        Node() {
-            key = UINT_MAX;
-            nextNodePtr = nullptr;
-        }
-
-        // Node initialized with a bid
-        Node(Bid myBid) : Node() {
-            bid = myBid;
-        }
-
-        Node(Bid myBid, unsigned newKey) : Node(myBid) {
-            key = newKey;
-        }
-    };
-
-    vector<Node> myNodes;
-
-    unsigned setSize = DEFAULT_SIZE;
-
-    unsigned int hash(int key);
-
-public:
-    HashTable();
-    HashTable(unsigned size);
-    virtual ~HashTable();
-    void Insert(Bid bid);
-    void PrintAll();
-    void Remove(string bidId);
-    Bid Search(string bidId);
-};
-
-/**
-* Default constructor
-*/
-HashTable::HashTable() {
-    // Initialize the structures used to hold bids
-    myNodes.resize(setSize);
-}
-
-HashTable::HashTable(unsigned size) {
-    this->setSize = size;
-    myNodes.resize(setSize);
-}
-
-/**
-* Destructor
-*/
-HashTable::~HashTable() {
-    // Implement logic to free storage when class is destroyed
-    myNodes.erase(myNodes.begin());
-}
-
-/**
-* Calculate the hash value of a given key.
-* Note that key is specifically defined as
-* unsigned int to prevent undefined results
-* of a negative list index.
-*
-* @param key The key to hash
-* @return The calculated hash
-*/
-unsigned int HashTable::hash(int key) {
-    // Implement logic to calculate a hash value
-    return key % setSize;
-}
-
-/**
-* Insert a bid
-*
-* @param bid The bid to insert
-*/
-void HashTable::Insert(Bid bid) {
-    // Implement logic to insert a bid
-    unsigned key = hash(atoi(bid.bidId.c_str()));
-
-    // search for node with the key value
-
-    Node* prevNode = &(myNodes.at(key));
-
-    if (prevNode == nullptr) {
-        Node* nextNode = new Node(bid, key);
-        myNodes.insert(myNodes.begin() + key, (*nextNode));
-    }
-    else {
-        // if node is found
-        if (prevNode->key == UINT_MAX) {
-            prevNode->key = key;
-            prevNode->bid = bid;
-            prevNode->nextNodePtr = nullptr;
-        }
-        else {
-            // if not found, find the next node available
-            while (prevNode->nextNodePtr != nullptr) {
-                prevNode = prevNode->nextNodePtr;
-            }
-        }
-    }
-}
-
-/**
-* Print all bids
-*/
-void HashTable::PrintAll() {
-    // Implement logic to print all bids
-    for (unsigned int i = 0; i < myNodes.size(); ++i) {
-        displayBid(myNodes[i].bid);
-    }
-}
-
-/**
-* Remove a bid
-*
-* @param bidId The bid id to search for
-*/
-void HashTable::Remove(string bidId) {
-    // Implement logic to remove a bid
-    unsigned key = hash(atoi(bidId.c_str()));
-    myNodes.erase(myNodes.begin() + key);
-}
-
-/**
-* Search for the specified bidId
-*
-* @param bidId The bid id to search for
-*/
-Bid HashTable::Search(string bidId) {
-    Bid bid;
-
-    // Implement logic to search for and return a bid
-    unsigned key = hash(atoi(bidId.c_str()));
-
-    // search for node with the key value
-
-    Node* node = &(myNodes.at(key));
-
-    // search for node using key
-
-    // if node is found by given key
-    if (node != nullptr && node->key != UINT_MAX
-        && node->bid.bidId.compare(bidId) == 0) {
-        return node->bid;
-    }
-
-    // if there is no node with the key value
-    if (node == nullptr || node->key == UINT_MAX) {
-        return bid;
-    }
-
-    // traverse list to look for a mat h
-    while (node != nullptr) {
-        if (node->key != UINT_MAX && node->bid.bidId.compare(bidId) == 0) {
-            return node->bid;
-        }
-        node = node->nextNodePtr;
-    }
-
-    return bid;
-}
-/**
-* Load a CSV file containing bids into a container
-*/
-void loadBids(string csvPath, HashTable* hashTable) {
+ * Load a CSV file containing bids into a hash table through a memory mapping
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param hashTable the table to insert into
+ */
+void loadBidsMapped(string csvPath, RobinHoodHashTable* hashTable) {
     cout << "Loading CSV file " << csvPath << endl;
 
-    // initialize the CSV Parser using the given path
-    csv::Parser file = csv::Parser(csvPath);
-
-    // read and display header row - optional
-    vector<string> header = file.getHeader();
-    for (auto const& c : header) {
-        cout << c << " | ";
-    }
-    cout << "" << endl;
-
     try {
-        // loop to read rows of a CSV file
-        for (unsigned int i = 0; i < file.rowCount(); i++) {
-
-            // Create a data structure and add to the collection of bids
-            Bid bid;
-            bid.bidId = file[i][1];
-            bid.title = file[i][0];
-            bid.fund = file[i][8];
-            bid.amount = strToDouble(file[i][4], '$');
-
-            //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
-
-            // push this bid to the end
-            hashTable->Insert(bid);
-        }
+        streamBids(csvPath, [hashTable](Bid&& bid) {
+            hashTable->Insert(move(bid));
+        });
     }
     catch (csv::Error& e) {
         std::cerr << e.what() << std::endl;
     }
 }
+
 /**
- * Simple C function to convert a string to a double
- * after stripping out unwanted char
- *
- * credit: http://stackoverflow.com/a/24875936
+ * Run a query through the table's secondary indexes, print the first
+ * matches, then time a full scan that answers the same question
  *
- * @param ch The character to strip out
+ * @param query the indexed query
+ * @param matches the same condition tested on one bid
  */
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+template <typename Query, typename Matches>
+void runIndexedQuery(const IndexedBidTable& table, Query query, Matches matches) {
+    const size_t SHOWN = 10;
+    auto start = chrono::steady_clock::now();
+    vector<const Bid*> found = query();
+    const double indexSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    vector<const Bid*> scanned;
+    table.ForEach([&matches, &scanned](const Bid& bid) {
+        if (matches(bid)) {
+            scanned.push_back(&bid);
+        }
+    });
+    const double scanSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < found.size() && i < SHOWN; ++i) {
+        displayBid(*found[i]);
+    }
+    if (found.size() > SHOWN) {
+        cout << "... and " << found.size() - SHOWN << " more" << endl;
+    }
+    cout << found.size() << " bids found" << endl;
+    cout << "index: " << indexSeconds * 1e6 << " us, full scan: " << scanSeconds * 1e6 << " us ("
+        << scanned.size() << " bids)" << endl;
 }
+
 /**
  * The one and only main() method
  */
@@ -642,25 +237,62 @@ int main(int argc, char* argv[]) {
 
     csvPath = "eBid_Monthly_Sales_Dec_2016.csv";
     csvPath2 = "eBid_Monthly_Sales.csv";
+    // headless benchmark run and dataset generator for scripts and CI, see BenchHarness.hpp
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        return runBenchHarness(argc - 2, argv + 2, csvPath2);
+    }
+    if (argc > 1 && string(argv[1]) == "--generate") {
+        return runGenerateCommand(argc - 2, argv + 2, csvPath2);
+    }
+    // either file can be replaced on the command line, by a CSV export or a bid snapshot
+    if (argc > 1) {
+        csvPath = argv[1];
+    }
+    if (argc > 2) {
+        csvPath2 = argv[2];
+    }
+    string snapshotPath;
     // Define a vector to hold all the bids
     vector<Bid> bids;
     // Define a Binary Tree to hold all the bids
-    BinarySearchTree* bst{};
+    BidTree* bst{};
     // Define a hash table to hold all the bids
-    HashTable* bidTable{};
+    RobinHoodHashTable* bidTable{};
+    // Define a B+ tree index to hold all the bids
+    BPlusTree bidIndex;
+    // Define a table with fund, amount and title indexes to hold all the bids
+    IndexedBidTable indexedBids;
+    // Define the columns sales reports total
+    SalesColumns salesColumns;
     Bid bid;
     // Define a timer variable
     clock_t ticks;
+    // hardware counters read around the same actions as the timer
+    PerfCounters perf;
 
     int fileChoice = 0;
     int dataStructureChoice = 0;
     int choice = 0;
+    unsigned threadCount = 0;
+    int keyChoice = 0;
+    int treeChoice = 0;
+    uint32_t lowKey = 0;
+    uint32_t highKey = 0;
+    double lowAmount = 0;
+    double highAmount = 0;
+    string queryText;
+    int measureChoice = 0;
 
     while (dataStructureChoice != 9) {
         cout << "Select a Data Structure:" << endl;
         cout << "  1. Vector" << endl;
         cout << "  2. Binary Tree" << endl;
         cout << "  3. Hash Table" << endl;
+        cout << "  4. B+ Tree" << endl;
+        cout << "  5. Benchmarks" << endl;
+        cout << "  6. Latency Stats" << endl;
+        cout << "  7. Indexed Queries" << endl;
+        cout << "  8. Sales Totals" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> dataStructureChoice;
@@ -673,6 +305,13 @@ int main(int argc, char* argv[]) {
                 cout << "  2. Display All Bids" << endl;
                 cout << "  3. Selection Sort All Bids" << endl;
                 cout << "  4. Quick Sort All Bids" << endl;
+                cout << "  5. Compare CSV Loaders" << endl;
+                cout << "  6. Parallel Load Bids" << endl;
+                cout << "  7. Pattern-Defeating Quick Sort All Bids" << endl;
+                cout << "  8. Index Sort All Bids" << endl;
+                cout << " 10. Parallel Sort All Bids" << endl;
+                cout << " 11. Radix Sort All Bids" << endl;
+                cout << " 12. Save Bids Snapshot" << endl;
                 cout << "  9. Return to main menu" << endl;
                 cout << "Enter choice: ";
                 cin >> choice;
@@ -681,6 +320,7 @@ int main(int argc, char* argv[]) {
                 case 1:
                     // Initialize a timer variable before loading bids
                     ticks = clock();
+                    perf.Start();
                         while (fileChoice != 1 && fileChoice != 2) {
                             cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
                             cin >> fileChoice;
@@ -688,19 +328,21 @@ int main(int argc, char* argv[]) {
                         }
                         if (fileChoice == 1) {
                             // Complete the method call to load the bids
-                            bids = loadBids(csvPath);
+                            bids = loadBidsMapped(csvPath);
                         }
                         else if (fileChoice == 2) {
                             // Complete the method call to load the bids
-                            bids = loadBids(csvPath2);
+                            bids = loadBidsMapped(csvPath2);
                         }
                         fileChoice = 0;
                     cout << bids.size() << " bids read" << endl;
 
                     // Calculate elapsed time and display result
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
 
                     break;
 
@@ -715,23 +357,179 @@ int main(int argc, char* argv[]) {
 
                 case 3:
                     ticks = clock();
+                    perf.Start();
                     selectionSort(bids);
 
                     // Calculate elapsed time and display result
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
 
                     break;
 
                 case 4:
                     ticks = clock();
+                    perf.Start();
                     quickSort(bids, 0, bids.size() - 1);
 
                     // Calculate elapsed time and display result
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+
+                    break;
+
+                case 5:
+                    while (fileChoice != 1 && fileChoice != 2) {
+                        cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
+                        cin >> fileChoice;
+                        cout << endl;
+                    }
+                    compareLoaders(fileChoice == 1 ? csvPath : csvPath2);
+                    fileChoice = 0;
+
+                    break;
+
+                case 6:
+                    while (fileChoice != 1 && fileChoice != 2) {
+                        cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
+                        cin >> fileChoice;
+                        cout << endl;
+                    }
+                    cout << "Enter number of threads (0 for all cores): ";
+                    cin >> threadCount;
+
+                    ticks = clock();
+                    perf.Start();
+                    bids = loadBidsParallel(fileChoice == 1 ? csvPath : csvPath2, threadCount);
+                    fileChoice = 0;
+                    cout << bids.size() << " bids read" << endl;
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+
+                    break;
+
+                case 7:
+                    while (keyChoice < 1 || keyChoice > 4) {
+                        cout << "Sort by 1. title, 2. bid id, 3. amount, 4. fund: ";
+                        cin >> keyChoice;
+                    }
+
+                    ticks = clock();
+                    perf.Start();
+                    if (keyChoice == 1) {
+                        pdqSortBy(bids.begin(), bids.end(), BidTitleKey());
+                    }
+                    else if (keyChoice == 2) {
+                        pdqSortBy(bids.begin(), bids.end(), BidIdKey());
+                    }
+                    else if (keyChoice == 3) {
+                        pdqSortBy(bids.begin(), bids.end(), BidAmountKey());
+                    }
+                    else {
+                        pdqSortBy(bids.begin(), bids.end(), BidFundKey());
+                    }
+                    keyChoice = 0;
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+
+                    break;
+
+                case 8:
+                    ticks = clock();
+                    perf.Start();
+                    // sort a permutation by title, then move each bid once
+                    applyPermutation(bids, sortedIndexByTitle(bids));
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+
+                    break;
+
+                case 10:
+                    cout << "Enter number of threads (0 for all cores): ";
+                    cin >> threadCount;
+
+                    ticks = clock();
+                    perf.Start();
+                    parallelSort(bids, threadCount);
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+
+                    break;
+
+                case 11:
+                    while (keyChoice < 1 || keyChoice > 3) {
+                        cout << "Sort by 1. title (MSD), 2. bid id (LSD), 3. amount in cents (LSD): ";
+                        cin >> keyChoice;
+                    }
+
+                    ticks = clock();
+                    perf.Start();
+                    if (keyChoice == 1) {
+                        radixSortByTitle(bids);
+                    }
+                    else if (keyChoice == 2) {
+                        radixSortByBidId(bids);
+                    }
+                    else {
+                        radixSortByAmount(bids);
+                    }
+                    keyChoice = 0;
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+
+                    break;
+
+                case 12:
+                    // load it later by giving this path in place of a CSV file
+                    cout << "Enter snapshot path: ";
+                    cin >> snapshotPath;
+
+                    ticks = clock();
+                    perf.Start();
+                    try {
+                        BidSnapshot::Write(snapshotPath, bids);
+                        cout << bids.size() << " bids written to " << snapshotPath << endl;
+                    }
+                    catch (csv::Error& e) {
+                        std::cerr << e.what() << std::endl;
+                    }
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
 
                     break;
                 default:
@@ -754,10 +552,23 @@ int main(int argc, char* argv[]) {
                 switch (choice) {
 
                 case 1:
-                    bst = new BinarySearchTree();
+                    while (treeChoice != 1 && treeChoice != 2) {
+                        cout << "Enter 1 for an unbalanced binary search tree, 2 for an AVL tree: ";
+                        cin >> treeChoice;
+                    }
+                    // drop the previous tree, if any, before loading a new one
+                    delete bst;
+                    if (treeChoice == 1) {
+                        bst = new BinarySearchTree();
+                    }
+                    else {
+                        bst = new AvlTree();
+                    }
+                    treeChoice = 0;
 
                     // Initialize a timer variable before loading bids
                     ticks = clock();
+                    perf.Start();
 
                     while (fileChoice != 1 && fileChoice != 2) {
                         cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
@@ -766,20 +577,23 @@ int main(int argc, char* argv[]) {
                     }
                     if (fileChoice == 1) {
                         // Complete the method call to load the bids
-                        loadBids(csvPath, bst);
+                        loadBidsMapped(csvPath, bst);
                     }
                     else if (fileChoice == 2) {
                         // Complete the method call to load the bids
-                        loadBids(csvPath2, bst);
+                        loadBidsMapped(csvPath2, bst);
                     }
                     fileChoice = 0;
 
-                    //cout << bst->Size() << " bids read" << endl;
-
                     // Calculate elapsed time and display result
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+
+                    cout << bst->Size() << " bids read, tree height " << bst->Height()
+                        << ", average search depth " << bst->AverageDepth() << endl;
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
                     break;
 
                 case 2:
@@ -788,11 +602,13 @@ int main(int argc, char* argv[]) {
 
                 case 3:
                     ticks = clock();
+                    perf.Start();
                     cout << "Enter Bid ID Ex: 98109" << endl;
                     cin >> bidKey;
                     bid = bst->Search(bidKey);
 
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
 
                     if (!bid.bidId.empty()) {
                         displayBid(bid);
@@ -803,6 +619,7 @@ int main(int argc, char* argv[]) {
 
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
 
                     break;
 
@@ -830,10 +647,12 @@ int main(int argc, char* argv[]) {
                 switch (choice) {
 
                 case 1:
-                    bidTable = new HashTable();
+                    delete bidTable;
+                    bidTable = new RobinHoodHashTable();
 
                     // Initialize a timer variable before loading bids
                     ticks = clock();
+                    perf.Start();
                     while (fileChoice != 1 && fileChoice != 2) {
                         cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
                         cin >> fileChoice;
@@ -841,18 +660,20 @@ int main(int argc, char* argv[]) {
                     }
                     if (fileChoice == 1) {
                         // Complete the method call to load the bids
-                        loadBids(csvPath, bidTable);
+                        loadBidsMapped(csvPath, bidTable);
                     }
                     else if (fileChoice == 2) {
                         // Complete the method call to load the bids
-                        loadBids(csvPath2, bidTable);
+                        loadBidsMapped(csvPath2, bidTable);
                     }
                     fileChoice = 0;
 
                     // Calculate elapsed time and display result
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
                     break;
 
                 case 2:
@@ -861,11 +682,13 @@ int main(int argc, char* argv[]) {
 
                 case 3:
                     ticks = clock();
+                    perf.Start();
                     cout << "Enter Bid ID Ex: 98109" << endl;
                     cin >> bidKey;
                     bid = bidTable->Search(bidKey);
 
                     ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
 
                     if (!bid.bidId.empty()) {
                         displayBid(bid);
@@ -876,6 +699,7 @@ int main(int argc, char* argv[]) {
 
                     cout << "time: " << ticks << " clock ticks" << endl;
                     cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
                     break;
 
                 case 4:
@@ -887,11 +711,433 @@ int main(int argc, char* argv[]) {
             }
             choice = 0;
             break;
+        case 4:
+            while (choice != 9) {
+                cout << "Menu:" << endl;
+                cout << "  1. Load Bids" << endl;
+                cout << "  2. Display All Bids" << endl;
+                cout << "  3. Find Bid" << endl;
+                cout << "  4. Remove Bid" << endl;
+                cout << "  5. Find Bid Id Range" << endl;
+                cout << "  9. Return to main menu" << endl;
+                cout << "Enter choice: ";
+                cin >> choice;
+
+                switch (choice) {
+
+                case 1:
+                    ticks = clock();
+                    perf.Start();
+                    while (fileChoice != 1 && fileChoice != 2) {
+                        cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
+                        cin >> fileChoice;
+                        cout << endl;
+                    }
+                    {
+                        // bulk load needs the bids in id order
+                        vector<Bid> loaded = loadBidsMapped(fileChoice == 1 ? csvPath : csvPath2);
+                        radixSortByBidId(loaded);
+                        bidIndex.BulkLoad(move(loaded));
+                    }
+                    fileChoice = 0;
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+
+                    cout << bidIndex.Size() << " bids read, tree height " << bidIndex.Height()
+                        << ", " << bidIndex.NodeCount() << " nodes" << endl;
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+                    break;
+
+                case 2:
+                    bidIndex.InOrder();
+                    break;
+
+                case 3:
+                    ticks = clock();
+                    perf.Start();
+                    cout << "Enter Bid ID Ex: 98109" << endl;
+                    cin >> bidKey;
+                    bid = bidIndex.Search(bidKey);
+
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+
+                    if (!bid.bidId.empty()) {
+                        displayBid(bid);
+                    }
+                    else {
+                        cout << "Bid Id " << bidKey << " not found." << endl;
+                    }
+
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+                    break;
+
+                case 4:
+                    cout << "Enter Bid ID Ex: 98109" << endl;
+                    cin >> bidKey;
+                    bidIndex.Remove(bidKey);
+                    break;
+
+                case 5:
+                    cout << "Enter the lowest and highest Bid ID Ex: 80000 81000" << endl;
+                    cin >> lowKey >> highKey;
+
+                    ticks = clock();
+                    perf.Start();
+                    {
+                        size_t found = bidIndex.ScanRange(lowKey, highKey, [](const Bid& match) {
+                            displayBid(match);
+                        });
+                        cout << found << " bids in range" << endl;
+                    }
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+                    break;
+                }
+            }
+            choice = 0;
+            break;
+        case 5:
+            while (choice != 9) {
+                cout << "Benchmarks:" << endl;
+                cout << "  1. CSV Tokenizer Modes" << endl;
+                cout << "  2. Parallel CSV Load Scaling" << endl;
+                cout << "  3. Currency Parsing" << endl;
+                cout << "  4. Bid Record Layout" << endl;
+                cout << "  5. Columnar Scans" << endl;
+                cout << "  6. Sort Engine" << endl;
+                cout << "  7. Index Sort" << endl;
+                cout << "  8. Parallel Sort Scaling" << endl;
+                cout << " 10. Balanced Tree" << endl;
+                cout << " 11. B+ Tree Index" << endl;
+                cout << " 12. Tree Node Pool" << endl;
+                cout << " 13. Open Addressing Hash Table" << endl;
+                cout << " 14. Incremental Rehash Latency" << endl;
+                cout << " 15. Concurrent Hash Table" << endl;
+                cout << " 16. Batched Lookups" << endl;
+                cout << " 17. Binary Snapshot Startup" << endl;
+                cout << " 18. Generated Data Pipeline" << endl;
+                cout << " 19. Latency Probe Overhead" << endl;
+                cout << " 20. Secondary Indexes" << endl;
+                cout << " 21. Bitmap Filters" << endl;
+                cout << " 22. Sales Aggregation" << endl;
+                cout << "  9. Return to main menu" << endl;
+                cout << "Enter choice: ";
+                cin >> choice;
+
+                // a missing or malformed file, or a snapshot where only a CSV will do,
+                // ends the benchmark rather than the program
+                try {
+                    switch (choice) {
+
+                    case 1:
+                        cout << csvPath << ":" << endl;
+                        verifyTokenizer(csvPath);
+                        cout << csvPath2 << ":" << endl;
+                        verifyTokenizer(csvPath2);
+                        // grow the full-year file past 1 GB
+                        benchTokenizer(csvPath2, size_t(1) << 30);
+                        break;
+
+                    case 2:
+                        benchParallelLoad(csvPath2, size_t(512) << 20);
+                        break;
+
+                    case 3:
+                        benchCurrencyParsing(csvPath2);
+                        break;
+
+                    case 4:
+                        benchBidLayout(csvPath2);
+                        break;
+
+                    case 5:
+                        benchColumnScan(csvPath2, 50000000);
+                        break;
+
+                    case 6:
+                        benchSortEngine(csvPath2);
+                        break;
+
+                    case 7:
+                        benchIndexSort(csvPath2, 10000000);
+                        break;
+
+                    case 8:
+                        benchParallelSort(csvPath2, 10000000);
+                        break;
+
+                    case 10:
+                        benchBidTrees(csvPath2);
+                        break;
+
+                    case 11:
+                        benchBPlusTree(csvPath2, 1000000);
+                        break;
+
+                    case 12:
+                        benchNodePool(csvPath2, 100);
+                        break;
+
+                    case 13:
+                        benchHashTables(csvPath2, 10000000);
+                        break;
+
+                    case 14:
+                        benchIncrementalRehash(50000000);
+                        break;
+
+                    case 15:
+                        benchConcurrentHashTable(1000000);
+                        break;
+
+                    case 16:
+                        benchBatchLookup(4000000);
+                        break;
+
+                    case 17:
+                        benchSnapshot(csvPath2, size_t(1) << 30);
+                        break;
+
+                    case 18:
+                        benchGeneratedPipeline(csvPath2, 5000000);
+                        break;
+
+                    case 19:
+                        benchLatencyProbes(1000000);
+                        break;
+
+                    case 20:
+                        benchSecondaryIndexes(csvPath2, 10000000);
+                        break;
+
+                    case 21:
+                        benchBitmapFilters(csvPath2, 10000000);
+                        break;
+
+                    case 22:
+                        benchAggregation(csvPath2, 100000000);
+                        break;
+                    }
+                }
+                catch (csv::Error& e) {
+                    cerr << e.what() << endl;
+                }
+            }
+            choice = 0;
+            break;
+
+        case 6:
+            while (choice != 9) {
+                cout << "Latency Stats (recording " << (latencyRecording() ? "on" : "off") << "):" << endl;
+                cout << "  1. Start Recording" << endl;
+                cout << "  2. Stop Recording" << endl;
+                cout << "  3. Show Percentiles" << endl;
+                cout << "  4. Reset" << endl;
+                cout << "  9. Return to main menu" << endl;
+                cout << "Enter choice: ";
+                cin >> choice;
+
+                switch (choice) {
+
+                case 1:
+                    setLatencyRecording(true);
+                    break;
+
+                case 2:
+                    setLatencyRecording(false);
+                    break;
+
+                case 3:
+                    printLatencyStats(cout);
+                    break;
+
+                case 4:
+                    resetLatencyStats();
+                    break;
+                }
+            }
+            choice = 0;
+            break;
+        case 7:
+            while (choice != 9) {
+                cout << "Indexed Queries:" << endl;
+                cout << "  1. Load Bids" << endl;
+                cout << "  2. Bids in Fund" << endl;
+                cout << "  3. Bids in Amount Range" << endl;
+                cout << "  4. Bids by Title Prefix" << endl;
+                cout << "  5. Remove Bid" << endl;
+                cout << "  6. Filter by Fund, Department and Pay Status" << endl;
+                cout << "  9. Return to main menu" << endl;
+                cout << "Enter choice: ";
+                cin >> choice;
+
+                switch (choice) {
+
+                case 1:
+                    while (fileChoice != 1 && fileChoice != 2) {
+                        cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
+                        cin >> fileChoice;
+                        cout << endl;
+                    }
+                    ticks = clock();
+                    perf.Start();
+                    indexedBids.Clear();
+                    try {
+                        streamBids(fileChoice == 1 ? csvPath : csvPath2, [&indexedBids](Bid&& loaded) {
+                            indexedBids.Insert(move(loaded));
+                        });
+                    }
+                    catch (csv::Error& e) {
+                        cerr << e.what() << endl;
+                    }
+                    fileChoice = 0;
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+
+                    cout << indexedBids.Size() << " bids read and indexed" << endl;
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+                    break;
+
+                case 2:
+                    cout << "Enter Fund Ex: General Fund" << endl;
+                    getline(cin >> ws, queryText);
+                    runIndexedQuery(indexedBids, [&]() { return indexedBids.InFund(queryText); },
+                                    [&queryText](const Bid& match) { return match.fund == queryText; });
+                    break;
+
+                case 3:
+                    cout << "Enter the lowest and highest amount Ex: 500 1000" << endl;
+                    cin >> lowAmount >> highAmount;
+                    runIndexedQuery(indexedBids, [&]() { return indexedBids.AmountBetween(lowAmount, highAmount); },
+                                    [&](const Bid& match) { return match.amount >= lowAmount && match.amount <= highAmount; });
+                    break;
+
+                case 4:
+                    cout << "Enter the start of a title Ex: Dell" << endl;
+                    getline(cin >> ws, queryText);
+                    runIndexedQuery(indexedBids, [&]() { return indexedBids.TitleStartsWith(queryText); },
+                                    [&queryText](const Bid& match) {
+                                        return match.title.compare(0, queryText.size(), queryText) == 0;
+                                    });
+                    break;
+
+                case 5:
+                    cout << "Enter Bid ID Ex: 98109" << endl;
+                    cin >> bidKey;
+                    if (!indexedBids.Remove(bidKey)) {
+                        cout << "Bid Id " << bidKey << " not found." << endl;
+                    }
+                    break;
+
+                case 6:
+                    cout << "Enter a filter Ex: department=\"DRUG TASK FORCE\" and not fund=Enterprise" << endl;
+                    getline(cin >> ws, queryText);
+                    {
+                        BidFilter filter;
+                        string problem;
+                        if (!BidFilter::Parse(queryText, filter, problem)) {
+                            cout << "Not a filter: " << problem << endl;
+                            break;
+                        }
+                        runIndexedQuery(indexedBids, [&]() { return indexedBids.Filter(filter); },
+                                        [&filter](const Bid& match) { return filter.Matches(match); });
+                    }
+                    break;
+                }
+            }
+            choice = 0;
+            break;
+        case 8:
+            while (choice != 9) {
+                cout << "Sales Totals:" << endl;
+                cout << "  1. Load Sales" << endl;
+                cout << "  2. Totals by Fund" << endl;
+                cout << "  3. Totals by Department" << endl;
+                cout << "  4. Totals by Month" << endl;
+                cout << "  9. Return to main menu" << endl;
+                cout << "Enter choice: ";
+                cin >> choice;
+
+                switch (choice) {
+
+                case 1:
+                    while (fileChoice != 1 && fileChoice != 2) {
+                        cout << "Enter 1 for the month of December file (170 items), 2 for the entire year (17,000 itmes) file: ";
+                        cin >> fileChoice;
+                        cout << endl;
+                    }
+                    ticks = clock();
+                    perf.Start();
+                    salesColumns = SalesColumns();
+                    try {
+                        cout << loadSalesColumns(fileChoice == 1 ? csvPath : csvPath2, salesColumns) << " bids read" << endl;
+                    }
+                    catch (csv::Error& e) {
+                        cerr << e.what() << endl;
+                    }
+                    fileChoice = 0;
+
+                    // Calculate elapsed time and display result
+                    ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                    perf.Stop();
+
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+                    break;
+
+                case 2:
+                case 3:
+                case 4:
+                    while (measureChoice < 1 || measureChoice > 3) {
+                        cout << "Enter 1 for the winning bids, 2 for the fees, 3 for the net sales: ";
+                        cin >> measureChoice;
+                        cout << endl;
+                    }
+                    ticks = clock();
+                    perf.Start();
+                    {
+                        const SalesGroup group = SalesGroup(choice - 2);
+                        vector<SalesTotals> totals = aggregateSales(salesColumns, group);
+
+                        ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+                        perf.Stop();
+
+                        printSalesTotals(cout, salesColumns, group, SalesMeasure(measureChoice - 1), totals);
+                    }
+                    measureChoice = 0;
+
+                    cout << "time: " << ticks << " clock ticks" << endl;
+                    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+                    printCounters(perf);
+                    break;
+                }
+            }
+            choice = 0;
+            break;
         default:
             break;
         }
      }
 
+    delete bst;
+    delete bidTable;
+
     cout << "Good bye." << endl;
     return 0;
 }
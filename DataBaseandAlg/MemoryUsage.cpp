@@ -0,0 +1,104 @@
+#include "MemoryUsage.hpp"
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+# include <psapi.h>
+# pragma comment(lib, "psapi.lib")
+#else
+# include <cstdio>
+# include <cstring>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#ifdef _WIN32
+std::size_t currentRssBytes() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return 0;
+    }
+    return pmc.WorkingSetSize;
+}
+
+std::size_t peakRssBytes() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return 0;
+    }
+    return pmc.PeakWorkingSetSize;
+}
+
+std::size_t availableMemoryBytes() {
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) {
+        return 0;
+    }
+    return static_cast<std::size_t>(status.ullAvailPhys);
+}
+
+bool resetPeakRss() {
+    return false;
+}
+
+bool dropFileCache(const char* path) {
+    return false;
+}
+#else
+/**
+ * Read one "Name:   1234 kB" line out of a /proc status file
+ */
+static std::size_t readStatusKb(const char* name, const char* path = "/proc/self/status") {
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) {
+        return 0;
+    }
+    char line[256];
+    std::size_t len = strlen(name);
+    std::size_t kb = 0;
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        if (strncmp(line, name, len) == 0 && line[len] == ':') {
+            sscanf(line + len + 1, "%zu", &kb);
+            break;
+        }
+    }
+    fclose(f);
+    return kb * 1024;
+}
+
+std::size_t currentRssBytes() {
+    return readStatusKb("VmRSS");
+}
+
+std::size_t peakRssBytes() {
+    return readStatusKb("VmHWM");
+}
+
+std::size_t availableMemoryBytes() {
+    return readStatusKb("MemAvailable", "/proc/meminfo");
+}
+
+bool resetPeakRss() {
+    // writing 5 to clear_refs resets VmHWM to the current RSS
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = fputs("5", f) >= 0;
+    return fclose(f) == 0 && ok;
+}
+
+bool dropFileCache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    // only clean pages nobody has mapped are dropped
+    bool ok = fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return ok;
+}
+#endif
@@ -0,0 +1,26 @@
+#ifndef     _MEMORYUSAGE_HPP_
+# define    _MEMORYUSAGE_HPP_
+
+# include <cstddef>
+
+/**
+ * Process memory figures used next to the timers in the menus.
+ * Every function returns 0 / false when the platform can't report it.
+ */
+
+// bytes currently resident
+std::size_t currentRssBytes();
+
+// highest resident size seen so far (or since the last reset)
+std::size_t peakRssBytes();
+
+// physical memory the OS could still hand out
+std::size_t availableMemoryBytes();
+
+// restart peak tracking from the current size, Linux only
+bool resetPeakRss();
+
+// evict a file's pages from the OS page cache so the next read comes from disk, Linux only
+bool dropFileCache(const char* path);
+
+#endif /*!_MEMORYUSAGE_HPP_*/
@@ -0,0 +1,125 @@
+#ifndef     _NODEPOOL_HPP_
+# define    _NODEPOOL_HPP_
+
+# include <algorithm>
+# include <cstddef>
+# include <functional>
+# include <new>
+# include <type_traits>
+# include <utility>
+# include <vector>
+
+/**
+ * Slab allocator for tree nodes. Nodes are carved one after another out
+ * of slabs of SlabSize() slots, so a tree built in one go sits in a few
+ * contiguous blocks instead of one malloc chunk per node. Destroy puts
+ * a slot on a freelist that the next Create reuses. Clear destroys every
+ * live node with one linear sweep over the slabs, never walking the
+ * tree, and hands each slab back with a single delete; for trivially
+ * destructible nodes the sweep is skipped entirely.
+ */
+template <class T>
+class NodePool {
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+public:
+    explicit NodePool(std::size_t slabSize = 1024) {
+        nodesPerSlab = slabSize == 0 ? 1 : slabSize;
+        freeList = nullptr;
+        usedInSlab = nodesPerSlab;
+        live = 0;
+        created = 0;
+        reused = 0;
+        slabAllocations = 0;
+    }
+
+    ~NodePool() {
+        Clear();
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    template <class... Args>
+    T* Create(Args&&... args) {
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->next;
+            ++reused;
+        }
+        else {
+            if (usedInSlab == nodesPerSlab) {
+                slabs.push_back(new Slot[nodesPerSlab]);
+                ++slabAllocations;
+                usedInSlab = 0;
+            }
+            slot = slabs.back() + usedInSlab++;
+        }
+        T* node = new (slot->storage) T(std::forward<Args>(args)...);
+        ++live;
+        ++created;
+        return node;
+    }
+
+    void Destroy(T* node) {
+        node->~T();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->next = freeList;
+        freeList = slot;
+        --live;
+    }
+
+    void Clear() {
+        if (!std::is_trivially_destructible<T>::value && live > 0) {
+            // every slot handed out and not on the freelist holds a node
+            std::vector<Slot*> released;
+            for (Slot* slot = freeList; slot != nullptr; slot = slot->next) {
+                released.push_back(slot);
+            }
+            std::sort(released.begin(), released.end(), std::less<Slot*>());
+            for (std::size_t s = 0; s < slabs.size(); ++s) {
+                const std::size_t used = s + 1 == slabs.size() ? usedInSlab : nodesPerSlab;
+                for (Slot* slot = slabs[s]; slot != slabs[s] + used; ++slot) {
+                    if (!std::binary_search(released.begin(), released.end(), slot, std::less<Slot*>())) {
+                        reinterpret_cast<T*>(slot->storage)->~T();
+                    }
+                }
+            }
+        }
+        for (Slot* slab : slabs) {
+            delete[] slab;
+        }
+        slabs.clear();
+        freeList = nullptr;
+        usedInSlab = nodesPerSlab;
+        live = 0;
+    }
+
+    std::size_t SlabSize() const { return nodesPerSlab; }
+    // nodes currently alive
+    std::size_t LiveCount() const { return live; }
+    // every Create so far, and how many of them reused a freed slot
+    std::size_t CreateCount() const { return created; }
+    std::size_t ReuseCount() const { return reused; }
+    // calls into the system allocator so far, one per slab
+    std::size_t SlabAllocations() const { return slabAllocations; }
+    std::size_t MemoryBytes() const { return slabs.size() * nodesPerSlab * sizeof(Slot); }
+
+private:
+    std::vector<Slot*> slabs;
+    std::size_t nodesPerSlab;
+    std::size_t usedInSlab;
+    Slot* freeList;
+    std::size_t live;
+    std::size_t created;
+    std::size_t reused;
+    std::size_t slabAllocations;
+};
+
+#endif /*!_NODEPOOL_HPP_*/
@@ -0,0 +1,220 @@
+#include <cstdio>
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+# include <cerrno>
+# include <cstdint>
+# include <cstring>
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+using namespace std;
+
+namespace {
+
+const char* const EVENT_NAMES[] = {
+    "cycles", "instructions", "cache_references", "cache_misses",
+    "branch_misses", "l1d_read_misses", "llc_read_misses"
+};
+
+// a count with a k, M or G suffix
+string shortCount(double count) {
+    const char* suffix = "";
+    if (count >= 1e9) {
+        count /= 1e9;
+        suffix = "G";
+    }
+    else if (count >= 1e6) {
+        count /= 1e6;
+        suffix = "M";
+    }
+    else if (count >= 1e4) {
+        count /= 1e3;
+        suffix = "k";
+    }
+    char text[32];
+    snprintf(text, sizeof(text), count >= 100 ? "%.0f%s" : "%.3g%s", count, suffix);
+    return text;
+}
+
+#ifdef __linux__
+struct EventCode {
+    uint32_t type;
+    uint64_t config;
+};
+
+uint64_t cacheMiss(uint64_t cache) {
+    return cache | (uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8)
+        | (uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+}
+
+const EventCode EVENT_CODES[] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL) }
+};
+
+// this thread and the threads it starts later, e.g. a ThreadPool's
+// workers; any CPU, user mode only, created stopped
+int openEvent(const EventCode& code) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = code.type;
+    attr.config = code.config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+}
+
+bool PerfCounters::Reading::Any() const {
+    for (bool c : counted) {
+        if (c) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double PerfCounters::Reading::IPC() const {
+    if (!Has(eCYCLES) || !Has(eINSTRUCTIONS) || value[eCYCLES] == 0) {
+        return 0;
+    }
+    return value[eINSTRUCTIONS] / value[eCYCLES];
+}
+
+void PerfCounters::Reading::Add(const Reading& other) {
+    for (int e = 0; e < eEVENT_COUNT; ++e) {
+        value[e] += other.value[e];
+        counted[e] = counted[e] && other.counted[e];
+    }
+}
+
+/**
+ * Constructor
+ */
+PerfCounters::PerfCounters() {
+    for (int e = 0; e < eEVENT_COUNT; ++e) {
+        fds[e] = -1;
+#ifdef __linux__
+        fds[e] = openEvent(EVENT_CODES[e]);
+        if (fds[e] < 0 && problem.empty()) {
+            problem = string(EVENT_NAMES[e]) + ": " + strerror(errno);
+            if (errno == EACCES || errno == EPERM) {
+                problem += " (see /proc/sys/kernel/perf_event_paranoid)";
+            }
+        }
+#endif
+    }
+#ifndef __linux__
+    problem = "hardware counters are only read on Linux";
+#endif
+}
+
+/**
+ * Destructor
+ */
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::Available() const {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::Start() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+const PerfCounters::Reading& PerfCounters::Stop() {
+    last = Reading();
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int e = 0; e < eEVENT_COUNT; ++e) {
+        // the count, then the time enabled and the time it was on a counter
+        uint64_t data[3];
+        if (fds[e] < 0 || read(fds[e], data, sizeof(data)) != ssize_t(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        last.value[e] = double(data[0]) * double(data[1]) / double(data[2]);
+        last.counted[e] = true;
+    }
+#endif
+    return last;
+}
+
+const char* PerfCounters::EventName(Event e) {
+    return EVENT_NAMES[e];
+}
+
+string PerfCounters::Describe(const Reading& reading, double ops) {
+    if (!reading.Any()) {
+        return string();
+    }
+    const double scale = ops > 1 ? 1.0 / ops : 1.0;
+    string text;
+    auto add = [&text](const string& part) {
+        text.append(text.empty() ? "" : ", ").append(part);
+    };
+    char ipc[32];
+    if (reading.IPC() != 0) {
+        snprintf(ipc, sizeof(ipc), "IPC %.2f", reading.IPC());
+        add(ipc);
+    }
+    if (reading.Has(eCYCLES)) {
+        add(shortCount(reading.value[eCYCLES] * scale) + " cycles");
+    }
+    if (reading.Has(eINSTRUCTIONS)) {
+        add(shortCount(reading.value[eINSTRUCTIONS] * scale) + " instructions");
+    }
+    if (reading.Has(eCACHE_MISSES) && reading.Has(eCACHE_REFERENCES)) {
+        add(shortCount(reading.value[eCACHE_MISSES] * scale) + " of "
+            + shortCount(reading.value[eCACHE_REFERENCES] * scale) + " cache refs missed");
+    }
+    else if (reading.Has(eCACHE_MISSES)) {
+        add(shortCount(reading.value[eCACHE_MISSES] * scale) + " cache misses");
+    }
+    if (reading.Has(eBRANCH_MISSES)) {
+        add(shortCount(reading.value[eBRANCH_MISSES] * scale) + " branch misses");
+    }
+    if (reading.Has(eL1D_READ_MISSES)) {
+        add(shortCount(reading.value[eL1D_READ_MISSES] * scale) + " L1d misses");
+    }
+    if (reading.Has(eLLC_READ_MISSES)) {
+        add(shortCount(reading.value[eLLC_READ_MISSES] * scale) + " LLC misses");
+    }
+    return ops > 1 ? text + " per op" : text;
+}
@@ -0,0 +1,79 @@
+#ifndef     _PERFCOUNTERS_HPP_
+# define    _PERFCOUNTERS_HPP_
+
+# include <string>
+
+/**
+ * Hardware performance counters around a timed action, through Linux
+ * perf_event_open. The calling thread is counted, in user mode, so it
+ * works at the default perf_event_paranoid level, together with threads
+ * it starts after the counters were made, like the ThreadPool workers of
+ * a parallel load or sort. A worker's counts are added in when it exits,
+ * so a pool has to be gone by Stop() to be counted. Each event is opened
+ * on its own: one the CPU or VM doesn't have is just left out. When the
+ * kernel time-shares more events than the PMU has counters, the counts
+ * are scaled up by the time each one was actually counting.
+ *
+ * Elsewhere, or with no events allowed, Available() is false and every
+ * Reading is empty, so callers print the times alone.
+ */
+class PerfCounters {
+
+public:
+    enum Event {
+        eCYCLES = 0,
+        eINSTRUCTIONS = 1,
+        eCACHE_REFERENCES = 2,
+        eCACHE_MISSES = 3,
+        eBRANCH_MISSES = 4,
+        eL1D_READ_MISSES = 5,
+        eLLC_READ_MISSES = 6,
+        eEVENT_COUNT = 7
+    };
+
+    struct Reading {
+        double value[eEVENT_COUNT] = {};
+        bool counted[eEVENT_COUNT] = {};
+
+        bool Has(Event e) const { return counted[e]; }
+        bool Any() const;
+        // instructions per cycle, 0 without both counts
+        double IPC() const;
+        // add another reading's counts; an event stays counted only if both have it
+        void Add(const Reading& other);
+    };
+
+private:
+    int fds[eEVENT_COUNT];
+    std::string problem;
+    Reading last;
+
+public:
+    PerfCounters();
+    virtual ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // at least one event could be opened
+    bool Available() const;
+    // why the first event that failed couldn't be opened, empty if none failed
+    const std::string& Problem() const { return problem; }
+
+    // zero and start every open event
+    void Start();
+    // stop them and read the counts since Start
+    const Reading& Stop();
+    const Reading& Last() const { return last; }
+
+    static const char* EventName(Event e);
+
+    /**
+     * One line such as "IPC 1.93, 1.2G cycles, 3.2M of 10M cache refs
+     * missed, ...", with every count divided by ops when ops is above 1
+     *
+     * @return empty when nothing was counted
+     */
+    static std::string Describe(const Reading& reading, double ops = 1);
+};
+
+#endif /*!_PERFCOUNTERS_HPP_*/
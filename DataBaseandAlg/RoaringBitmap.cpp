@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <iterator>
+#include "CpuFeatures.hpp"
+#include "RoaringBitmap.hpp"
+using namespace std;
+
+namespace {
+
+const size_t BITMAP_WORDS = 1024;
+
+enum WordOp {
+    eWORD_AND = 0,
+    eWORD_OR = 1,
+    eWORD_ANDNOT = 2
+};
+
+unsigned popcount64(uint64_t x) {
+#ifdef __GNUC__
+    return unsigned(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return unsigned((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/**
+ * out = a op b over a container's words
+ *
+ * @return the number of bits set in out
+ */
+uint32_t combineScalar(const uint64_t* a, const uint64_t* b, uint64_t* out, WordOp op) {
+    uint32_t count = 0;
+    for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+        out[i] = op == eWORD_AND ? a[i] & b[i] : op == eWORD_OR ? a[i] | b[i] : a[i] & ~b[i];
+        count += popcount64(out[i]);
+    }
+    return count;
+}
+
+#ifdef HAVE_X86
+/**
+ * Bits set in each 64-bit lane: a 16-entry table lookup per nibble with
+ * pshufb, then the bytes of each lane summed with sad
+ */
+TARGET_AVX2 inline __m256i popcount256(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+    const __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+TARGET_AVX2 uint32_t combineAvx2(const uint64_t* a, const uint64_t* b, uint64_t* out, WordOp op) {
+    __m256i counts = _mm256_setzero_si256();
+    for (size_t i = 0; i < BITMAP_WORDS; i += 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i r = op == eWORD_AND ? _mm256_and_si256(x, y)
+            : op == eWORD_OR ? _mm256_or_si256(x, y) : _mm256_andnot_si256(y, x);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+        counts = _mm256_add_epi64(counts, popcount256(r));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counts);
+    return uint32_t(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+#endif
+
+uint32_t combineWords(const uint64_t* a, const uint64_t* b, uint64_t* out, WordOp op) {
+#ifdef HAVE_X86
+    static const bool avx2 = cpuHasAvx2();
+    if (avx2) {
+        return combineAvx2(a, b, out, op);
+    }
+#endif
+    return combineScalar(a, b, out, op);
+}
+
+inline bool testBit(const vector<uint64_t>& words, uint16_t low) {
+    return (words[low / 64] >> (low % 64)) & 1;
+}
+}
+
+vector<RoaringBitmap::Container>::iterator RoaringBitmap::find(uint16_t key) {
+    return lower_bound(containers.begin(), containers.end(), key,
+                       [](const Container& c, uint16_t k) { return c.key < k; });
+}
+
+vector<RoaringBitmap::Container>::const_iterator RoaringBitmap::find(uint16_t key) const {
+    return lower_bound(containers.begin(), containers.end(), key,
+                       [](const Container& c, uint16_t k) { return c.key < k; });
+}
+
+void RoaringBitmap::toBitmap(Container& c) {
+    c.words.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : c.values) {
+        c.words[low / 64] |= uint64_t(1) << (low % 64);
+    }
+    c.values.clear();
+    c.values.shrink_to_fit();
+}
+
+void RoaringBitmap::toArrayIfSmall(Container& c) {
+    if (!c.IsBitmap() || c.cardinality > ARRAY_MAX) {
+        return;
+    }
+    c.values.reserve(c.cardinality);
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        for (uint64_t bits = c.words[w]; bits != 0; bits &= bits - 1) {
+            c.values.push_back(uint16_t(w * 64 + trailingZeros64(bits)));
+        }
+    }
+    c.words.clear();
+    c.words.shrink_to_fit();
+}
+
+void RoaringBitmap::Add(uint32_t row) {
+    const uint16_t key = uint16_t(row >> 16), low = uint16_t(row);
+    // rows usually arrive in order, so try the last container first
+    vector<Container>::iterator c = !containers.empty() && containers.back().key == key
+        ? containers.end() - 1 : find(key);
+    if (c == containers.end() || c->key != key) {
+        c = containers.insert(c, Container{ key, 0, {}, {} });
+    }
+    if (!c->IsBitmap()) {
+        vector<uint16_t>::iterator at = lower_bound(c->values.begin(), c->values.end(), low);
+        if (at != c->values.end() && *at == low) {
+            return;
+        }
+        if (c->cardinality < ARRAY_MAX) {
+            c->values.insert(at, low);
+            ++c->cardinality;
+            return;
+        }
+        toBitmap(*c);
+    }
+    uint64_t& word = c->words[low / 64];
+    const uint64_t bit = uint64_t(1) << (low % 64);
+    if ((word & bit) == 0) {
+        word |= bit;
+        ++c->cardinality;
+    }
+}
+
+bool RoaringBitmap::Remove(uint32_t row) {
+    const uint16_t key = uint16_t(row >> 16), low = uint16_t(row);
+    vector<Container>::iterator c = find(key);
+    if (c == containers.end() || c->key != key) {
+        return false;
+    }
+    if (c->IsBitmap()) {
+        uint64_t& word = c->words[low / 64];
+        const uint64_t bit = uint64_t(1) << (low % 64);
+        if ((word & bit) == 0) {
+            return false;
+        }
+        word &= ~bit;
+        --c->cardinality;
+        toArrayIfSmall(*c);
+    }
+    else {
+        vector<uint16_t>::iterator at = lower_bound(c->values.begin(), c->values.end(), low);
+        if (at == c->values.end() || *at != low) {
+            return false;
+        }
+        c->values.erase(at);
+        --c->cardinality;
+    }
+    if (c->cardinality == 0) {
+        containers.erase(c);
+    }
+    return true;
+}
+
+bool RoaringBitmap::Contains(uint32_t row) const {
+    const uint16_t key = uint16_t(row >> 16), low = uint16_t(row);
+    vector<Container>::const_iterator c = find(key);
+    if (c == containers.end() || c->key != key) {
+        return false;
+    }
+    return c->IsBitmap() ? testBit(c->words, low) : binary_search(c->values.begin(), c->values.end(), low);
+}
+
+size_t RoaringBitmap::Cardinality() const {
+    size_t count = 0;
+    for (const Container& c : containers) {
+        count += c.cardinality;
+    }
+    return count;
+}
+
+size_t RoaringBitmap::MemoryBytes() const {
+    size_t bytes = sizeof(*this) + containers.capacity() * sizeof(Container);
+    for (const Container& c : containers) {
+        bytes += c.values.capacity() * sizeof(uint16_t) + c.words.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void RoaringBitmap::andContainers(const Container& a, const Container& b, Container& out) {
+    if (a.IsBitmap() && b.IsBitmap()) {
+        out.words.resize(BITMAP_WORDS);
+        out.cardinality = combineWords(a.words.data(), b.words.data(), out.words.data(), eWORD_AND);
+        toArrayIfSmall(out);
+        return;
+    }
+    if (a.IsBitmap() || b.IsBitmap()) {
+        const Container& array = a.IsBitmap() ? b : a;
+        const Container& bitmap = a.IsBitmap() ? a : b;
+        for (uint16_t low : array.values) {
+            if (testBit(bitmap.words, low)) {
+                out.values.push_back(low);
+            }
+        }
+    }
+    else {
+        set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                         back_inserter(out.values));
+    }
+    out.cardinality = uint32_t(out.values.size());
+}
+
+void RoaringBitmap::orContainers(const Container& a, const Container& b, Container& out) {
+    if (a.IsBitmap() && b.IsBitmap()) {
+        out.words.resize(BITMAP_WORDS);
+        out.cardinality = combineWords(a.words.data(), b.words.data(), out.words.data(), eWORD_OR);
+        return;
+    }
+    if (a.IsBitmap() || b.IsBitmap()) {
+        const Container& array = a.IsBitmap() ? b : a;
+        const Container& bitmap = a.IsBitmap() ? a : b;
+        out.words = bitmap.words;
+        out.cardinality = bitmap.cardinality;
+        for (uint16_t low : array.values) {
+            uint64_t& word = out.words[low / 64];
+            const uint64_t bit = uint64_t(1) << (low % 64);
+            out.cardinality += (word & bit) == 0;
+            word |= bit;
+        }
+        return;
+    }
+    set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), back_inserter(out.values));
+    out.cardinality = uint32_t(out.values.size());
+    if (out.cardinality > ARRAY_MAX) {
+        toBitmap(out);
+    }
+}
+
+void RoaringBitmap::andNotContainers(const Container& a, const Container& b, Container& out) {
+    if (a.IsBitmap() && b.IsBitmap()) {
+        out.words.resize(BITMAP_WORDS);
+        out.cardinality = combineWords(a.words.data(), b.words.data(), out.words.data(), eWORD_ANDNOT);
+    }
+    else if (a.IsBitmap()) {
+        out.words = a.words;
+        out.cardinality = a.cardinality;
+        for (uint16_t low : b.values) {
+            uint64_t& word = out.words[low / 64];
+            const uint64_t bit = uint64_t(1) << (low % 64);
+            out.cardinality -= (word & bit) != 0;
+            word &= ~bit;
+        }
+    }
+    else if (b.IsBitmap()) {
+        for (uint16_t low : a.values) {
+            if (!testBit(b.words, low)) {
+                out.values.push_back(low);
+            }
+        }
+        out.cardinality = uint32_t(out.values.size());
+    }
+    else {
+        set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                       back_inserter(out.values));
+        out.cardinality = uint32_t(out.values.size());
+    }
+    toArrayIfSmall(out);
+}
+
+RoaringBitmap RoaringBitmap::And(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    vector<Container>::const_iterator a = containers.begin(), b = other.containers.begin();
+    while (a != containers.end() && b != other.containers.end()) {
+        if (a->key < b->key) {
+            ++a;
+        }
+        else if (b->key < a->key) {
+            ++b;
+        }
+        else {
+            Container out{ a->key, 0, {}, {} };
+            andContainers(*a, *b, out);
+            if (out.cardinality != 0) {
+                result.containers.push_back(move(out));
+            }
+            ++a;
+            ++b;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::Or(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    vector<Container>::const_iterator a = containers.begin(), b = other.containers.begin();
+    while (a != containers.end() || b != other.containers.end()) {
+        if (b == other.containers.end() || (a != containers.end() && a->key < b->key)) {
+            result.containers.push_back(*a++);
+        }
+        else if (a == containers.end() || b->key < a->key) {
+            result.containers.push_back(*b++);
+        }
+        else {
+            Container out{ a->key, 0, {}, {} };
+            orContainers(*a, *b, out);
+            result.containers.push_back(move(out));
+            ++a;
+            ++b;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::AndNot(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    vector<Container>::const_iterator b = other.containers.begin();
+    for (const Container& a : containers) {
+        while (b != other.containers.end() && b->key < a.key) {
+            ++b;
+        }
+        if (b == other.containers.end() || b->key != a.key) {
+            result.containers.push_back(a);
+            continue;
+        }
+        Container out{ a.key, 0, {}, {} };
+        andNotContainers(a, *b, out);
+        if (out.cardinality != 0) {
+            result.containers.push_back(move(out));
+        }
+    }
+    return result;
+}
+
+void RoaringBitmap::AppendTo(vector<uint32_t>& rows) const {
+    for (const Container& c : containers) {
+        const uint32_t base = uint32_t(c.key) << 16;
+        if (!c.IsBitmap()) {
+            for (uint16_t low : c.values) {
+                rows.push_back(base | low);
+            }
+            continue;
+        }
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            for (uint64_t bits = c.words[w]; bits != 0; bits &= bits - 1) {
+                rows.push_back(base | uint32_t(w * 64 + trailingZeros64(bits)));
+            }
+        }
+    }
+}
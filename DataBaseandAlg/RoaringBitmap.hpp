@@ -0,0 +1,71 @@
+#ifndef     _ROARINGBITMAP_HPP_
+# define    _ROARINGBITMAP_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+/**
+ * A compressed set of 32-bit row numbers in the Roaring layout. Rows are
+ * split by their high 16 bits into containers. A container is a sorted
+ * array of the low 16 bits while it holds at most ARRAY_MAX rows, and a
+ * 65536-bit bitmap above that, so a sparse value costs 2 bytes a row and
+ * a dense one never more than 1 bit.
+ *
+ * And, Or and AndNot go container by container: two bitmaps combine a
+ * whole 8 KB word array at a time, with AVX2 when the CPU has it, and
+ * arrays merge or probe the other side. There are no run containers;
+ * rows here are numbered in load order, so long runs are rare.
+ */
+class RoaringBitmap {
+
+public:
+    // an array container past this many rows becomes a bitmap
+    static const std::size_t ARRAY_MAX = 4096;
+
+private:
+    struct Container {
+        std::uint16_t key;
+        std::uint32_t cardinality;
+        // sorted low halves while an array, empty once a bitmap
+        std::vector<std::uint16_t> values;
+        // 1024 words once a bitmap, empty while an array
+        std::vector<std::uint64_t> words;
+
+        bool IsBitmap() const { return !words.empty(); }
+    };
+
+    // sorted by key
+    std::vector<Container> containers;
+
+    std::vector<Container>::iterator find(std::uint16_t key);
+    std::vector<Container>::const_iterator find(std::uint16_t key) const;
+    static void toBitmap(Container& c);
+    static void toArrayIfSmall(Container& c);
+    static void andContainers(const Container& a, const Container& b, Container& out);
+    static void orContainers(const Container& a, const Container& b, Container& out);
+    static void andNotContainers(const Container& a, const Container& b, Container& out);
+
+public:
+    void Add(std::uint32_t row);
+    // @return false if the row wasn't there
+    bool Remove(std::uint32_t row);
+    bool Contains(std::uint32_t row) const;
+
+    std::size_t Cardinality() const;
+    bool Empty() const { return containers.empty(); }
+    void Clear() { containers.clear(); }
+
+    // heap and object bytes, containers included
+    std::size_t MemoryBytes() const;
+
+    RoaringBitmap And(const RoaringBitmap& other) const;
+    RoaringBitmap Or(const RoaringBitmap& other) const;
+    // rows here that are not in other
+    RoaringBitmap AndNot(const RoaringBitmap& other) const;
+
+    // append every row, lowest first
+    void AppendTo(std::vector<std::uint32_t>& rows) const;
+};
+
+#endif /*!_ROARINGBITMAP_HPP_*/
@@ -0,0 +1,462 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "CpuFeatures.hpp"
+#include "LatencyStats.hpp"
+#include "RobinHoodHashTable.hpp"
+using namespace std;
+
+const size_t NOT_FOUND = size_t(-1);
+
+/**
+ * Constructor
+ *
+ * @param maxLoadFactor fraction of slots in use that triggers doubling,
+ *                      clamped to [0.25, 0.95]
+ * @param initialCapacity slots to start with, rounded up to a power of two
+ * @param mode whether growing moves the old entries a few at a time or
+ *             all in the insert that triggers it
+ */
+RobinHoodHashTable::RobinHoodHashTable(double maxLoadFactor, size_t initialCapacity, RehashMode mode) {
+    this->maxLoadFactor = min(0.95, max(0.25, maxLoadFactor));
+    this->mode = mode;
+    size_t capacity = 8;
+    while (capacity < initialCapacity) {
+        capacity *= 2;
+    }
+    allocate(table, capacity);
+    migrateStart = 0;
+    migrated = 0;
+    recordCount = 0;
+}
+
+/**
+ * Destructor
+ */
+RobinHoodHashTable::~RobinHoodHashTable() {
+    Clear();
+    release(table);
+}
+
+/**
+ * murmur3's 32-bit finalizer: every input bit affects every output bit,
+ * so the low bits used as the slot index are well spread even for
+ * consecutive ids
+ */
+uint32_t RobinHoodHashTable::mix(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6bu;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35u;
+    key ^= key >> 16;
+    return key;
+}
+
+/**
+ * calloc rather than a zero-filling loop: large blocks come straight
+ * from the OS already zeroed, so a new table's pages are only touched
+ * as entries land in them
+ */
+void RobinHoodHashTable::allocate(Table& t, size_t capacity) {
+    t.distances = static_cast<uint8_t*>(calloc(capacity, sizeof(uint8_t)));
+    t.slots = static_cast<Slot*>(calloc(capacity, sizeof(Slot)));
+    if (t.distances == nullptr || t.slots == nullptr) {
+        release(t);
+        throw bad_alloc();
+    }
+    t.mask = capacity - 1;
+}
+
+void RobinHoodHashTable::release(Table& t) {
+    free(t.distances);
+    free(t.slots);
+    t.distances = nullptr;
+    t.slots = nullptr;
+    t.mask = 0;
+}
+
+Bid& RobinHoodHashTable::record(uint32_t index) const {
+    return recordChunks[index / RECORD_CHUNK][index % RECORD_CHUNK];
+}
+
+/**
+ * @return the slot of t holding key, or NOT_FOUND
+ */
+size_t RobinHoodHashTable::findIn(const Table& t, uint32_t key) {
+    return findFrom(t, key, mix(key) & t.mask);
+}
+
+/**
+ * findIn with the home slot already worked out
+ */
+size_t RobinHoodHashTable::findFrom(const Table& t, uint32_t key, size_t home) {
+    size_t i = home;
+    for (unsigned distance = 1; ; ++distance) {
+        // an entry closer to home than we would be means key isn't here
+        if (t.distances[i] < distance) {
+            return NOT_FOUND;
+        }
+        if (t.slots[i].key == key) {
+            return i;
+        }
+        i = (i + 1) & t.mask;
+    }
+}
+
+/**
+ * findIn for the table being migrated. Migrated slots are empty, so a
+ * key whose home slot is already done starts probing at the first slot
+ * not yet migrated, at the distance it would have there.
+ */
+size_t RobinHoodHashTable::findInOld(uint32_t key) const {
+    if (!Rehashing()) {
+        return NOT_FOUND;
+    }
+    size_t i = mix(key) & old.mask;
+    size_t distance = 1;
+    const size_t offset = (i - migrateStart) & old.mask;
+    if (offset < migrated) {
+        i = (migrateStart + migrated) & old.mask;
+        distance = migrated - offset + 1;
+    }
+    for (; ; ++distance) {
+        if (old.distances[i] < distance) {
+            return NOT_FOUND;
+        }
+        if (old.slots[i].key == key) {
+            return i;
+        }
+        i = (i + 1) & old.mask;
+    }
+}
+
+RobinHoodHashTable::Slot* RobinHoodHashTable::findSlot(uint32_t key) const {
+    size_t i = findIn(table, key);
+    if (i != NOT_FOUND) {
+        return &table.slots[i];
+    }
+    i = findInOld(key);
+    return i == NOT_FOUND ? nullptr : &old.slots[i];
+}
+
+/**
+ * Slots a lookup probed to reach a slot findSlot returned, its own included
+ */
+unsigned RobinHoodHashTable::distanceOf(const Slot* slot) const {
+    if (slot >= table.slots && slot < table.slots + table.capacity()) {
+        return table.distances[slot - table.slots];
+    }
+    return old.distances[slot - old.slots];
+}
+
+/**
+ * Put an entry that is not in t yet into its Robin Hood position,
+ * displacing richer entries along the way
+ *
+ * @return false if some entry would end up MAX_DISTANCE from home; key
+ *         and record then hold the entry still without a slot
+ */
+bool RobinHoodHashTable::placeIn(Table& t, uint32_t& key, uint32_t& record) {
+    size_t i = mix(key) & t.mask;
+    uint8_t distance = 1;
+    for (;;) {
+        if (t.distances[i] == 0) {
+            t.distances[i] = distance;
+            t.slots[i].key = key;
+            t.slots[i].record = record;
+            return true;
+        }
+        if (t.distances[i] < distance) {
+            swap(distance, t.distances[i]);
+            swap(key, t.slots[i].key);
+            swap(record, t.slots[i].record);
+        }
+        i = (i + 1) & t.mask;
+        if (++distance == MAX_DISTANCE) {
+            return false;
+        }
+    }
+}
+
+/**
+ * Empty slot i by shifting the run after it back one slot, up to an
+ * empty slot or an entry in its home slot. In the table being migrated
+ * the run only moves towards i, so nothing crosses into the migrated part.
+ */
+void RobinHoodHashTable::removeAt(Table& t, size_t i) {
+    size_t next = (i + 1) & t.mask;
+    while (t.distances[next] > 1) {
+        t.slots[i] = t.slots[next];
+        t.distances[i] = t.distances[next] - 1;
+        i = next;
+        next = (next + 1) & t.mask;
+    }
+    t.distances[i] = 0;
+}
+
+/**
+ * Move up to steps slots of the old table into the current one, and let
+ * the old table go once every slot has been moved
+ */
+void RobinHoodHashTable::migrate(size_t steps) {
+    if (!Rehashing()) {
+        return;
+    }
+    const size_t capacity = old.capacity();
+    for (; steps > 0 && migrated < capacity; --steps) {
+        const size_t i = (migrateStart + migrated) & old.mask;
+        ++migrated;
+        if (old.distances[i] != 0) {
+            Slot entry = old.slots[i];
+            old.distances[i] = 0;
+            if (!placeIn(table, entry.key, entry.record)) {
+                rebuild(table.capacity() * 2, &entry);
+                return;
+            }
+        }
+    }
+    if (migrated == capacity) {
+        release(old);
+    }
+}
+
+/**
+ * Make room for one more entry. Incrementally, the current slots become
+ * the old table and migration starts from an empty slot, so no run of
+ * entries wraps from the unmigrated part into the migrated part.
+ */
+void RobinHoodHashTable::grow() {
+    if (mode == eREHASH_ALL_AT_ONCE) {
+        rebuild(table.capacity() * 2);
+        return;
+    }
+
+    // only reached if inserts outpaced MIGRATE_STEP, e.g. after a rebuild
+    migrate(old.capacity());
+    if (recordCount + 1 <= table.capacity() * maxLoadFactor) {
+        return;
+    }
+
+    old = table;
+    allocate(table, old.capacity() * 2);
+    migrateStart = 0;
+    while (old.distances[migrateStart] != 0) {
+        ++migrateStart;
+    }
+    migrated = 0;
+}
+
+/**
+ * Place every entry of both tables, plus homeless if given, into one
+ * fresh table of at least capacity slots, doubling until they all fit
+ */
+void RobinHoodHashTable::rebuild(size_t capacity, const Slot* homeless) {
+    Table fresh;
+    for (; ; capacity *= 2) {
+        allocate(fresh, capacity);
+        bool placed = true;
+        if (homeless != nullptr) {
+            Slot entry = *homeless;
+            placed = placeIn(fresh, entry.key, entry.record);
+        }
+        const Table* sources[] = { &table, &old };
+        for (const Table* source : sources) {
+            for (size_t i = 0; placed && i < source->capacity(); ++i) {
+                if (source->distances[i] != 0) {
+                    Slot entry = source->slots[i];
+                    placed = placeIn(fresh, entry.key, entry.record);
+                }
+            }
+        }
+        if (placed) {
+            break;
+        }
+        release(fresh);
+    }
+    release(table);
+    release(old);
+    table = fresh;
+    migrated = 0;
+}
+
+/**
+ * Insert a bid, replacing any bid with the same id
+ *
+ * @return false if the bid id is not a number
+ */
+bool RobinHoodHashTable::Insert(Bid bid) {
+    LatencyProbe probe(eLATENCY_ROBIN_HOOD, eLATENCY_INSERT);
+    uint32_t key;
+    if (!bidIdToKey(bid.bidId, key)) {
+        return false;
+    }
+    migrate(MIGRATE_STEP);
+
+    Slot* slot = findSlot(key);
+    if (slot != nullptr) {
+        record(slot->record) = move(bid);
+        return true;
+    }
+
+    if (recordCount + 1 > table.capacity() * maxLoadFactor) {
+        grow();
+    }
+    if (recordCount == recordChunks.size() * RECORD_CHUNK) {
+        recordChunks.push_back(static_cast<Bid*>(::operator new(RECORD_CHUNK * sizeof(Bid))));
+    }
+    uint32_t index = uint32_t(recordCount);
+    new (&record(index)) Bid(move(bid));
+    ++recordCount;
+
+    Slot entry = { key, index };
+    if (!placeIn(table, entry.key, entry.record)) {
+        rebuild(table.capacity() * 2, &entry);
+    }
+    return true;
+}
+
+/**
+ * Print all bids in slot order
+ */
+void RobinHoodHashTable::PrintAll() const {
+    const Table* sources[] = { &table, &old };
+    for (const Table* source : sources) {
+        for (size_t i = 0; i < source->capacity(); ++i) {
+            if (source->distances[i] != 0) {
+                displayBid(record(source->slots[i].record));
+            }
+        }
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @return false if there was no bid with that id
+ */
+bool RobinHoodHashTable::Remove(string bidId) {
+    LatencyProbe probe(eLATENCY_ROBIN_HOOD, eLATENCY_REMOVE);
+    uint32_t key;
+    if (!bidIdToKey(bidId, key)) {
+        return false;
+    }
+    migrate(MIGRATE_STEP);
+
+    Table* owner = &table;
+    size_t i = findIn(table, key);
+    if (i == NOT_FOUND) {
+        owner = &old;
+        i = findInOld(key);
+    }
+    if (i == NOT_FOUND) {
+        return false;
+    }
+    const uint32_t removed = owner->slots[i].record;
+    removeAt(*owner, i);
+
+    // keep the bids dense: the last one moves into the hole
+    const uint32_t last = uint32_t(recordCount - 1);
+    if (removed != last) {
+        record(removed) = move(record(last));
+        uint32_t movedKey;
+        bidIdToKey(record(removed).bidId, movedKey);
+        findSlot(movedKey)->record = removed;
+    }
+    record(last).~Bid();
+    --recordCount;
+    return true;
+}
+
+const Bid* RobinHoodHashTable::Find(uint32_t key) {
+    migrate(MIGRATE_STEP);
+    return static_cast<const RobinHoodHashTable*>(this)->Find(key);
+}
+
+const Bid* RobinHoodHashTable::Find(uint32_t key) const {
+    const Slot* slot = findSlot(key);
+    return slot == nullptr ? nullptr : &record(slot->record);
+}
+
+void RobinHoodHashTable::SearchBatch(const uint32_t* keys, size_t count, const Bid** out) const {
+    size_t homes[BATCH_GROUP];
+    for (size_t first = 0; first < count; first += BATCH_GROUP) {
+        const size_t n = min(count - first, size_t(BATCH_GROUP));
+        for (size_t j = 0; j < n; ++j) {
+            homes[j] = mix(keys[first + j]) & table.mask;
+            prefetchRead(&table.distances[homes[j]]);
+            prefetchRead(&table.slots[homes[j]]);
+        }
+        for (size_t j = 0; j < n; ++j) {
+            const uint32_t key = keys[first + j];
+            const Slot* slot = nullptr;
+            size_t i = findFrom(table, key, homes[j]);
+            if (i != NOT_FOUND) {
+                slot = &table.slots[i];
+            }
+            else if ((i = findInOld(key)) != NOT_FOUND) {
+                slot = &old.slots[i];
+            }
+            out[first + j] = slot == nullptr ? nullptr : &record(slot->record);
+            if (slot != nullptr) {
+                prefetchRead(out[first + j]);
+            }
+        }
+    }
+}
+
+/**
+ * Search for the specified bidId
+ */
+Bid RobinHoodHashTable::Search(string bidId) {
+    LatencyProbe probe(eLATENCY_ROBIN_HOOD, eLATENCY_SEARCH);
+    uint32_t key;
+    if (!bidIdToKey(bidId, key)) {
+        return Bid();
+    }
+    migrate(MIGRATE_STEP);
+    const Slot* slot = findSlot(key);
+    if (slot == nullptr) {
+        return Bid();
+    }
+    probe.Work(distanceOf(slot));
+    return record(slot->record);
+}
+
+void RobinHoodHashTable::Clear() {
+    release(old);
+    memset(table.distances, 0, table.capacity());
+    migrated = 0;
+    for (size_t i = 0; i < recordCount; ++i) {
+        record(uint32_t(i)).~Bid();
+    }
+    for (Bid* chunk : recordChunks) {
+        ::operator delete(chunk);
+    }
+    recordChunks.clear();
+    recordCount = 0;
+}
+
+size_t RobinHoodHashTable::MemoryBytes() const {
+    return (table.capacity() + old.capacity()) * (sizeof(uint8_t) + sizeof(Slot))
+         + recordChunks.size() * RECORD_CHUNK * sizeof(Bid)
+         + recordChunks.capacity() * sizeof(recordChunks[0]);
+}
+
+vector<size_t> RobinHoodHashTable::ProbeHistogram() const {
+    vector<size_t> histogram;
+    const Table* sources[] = { &table, &old };
+    for (const Table* source : sources) {
+        for (size_t i = 0; i < source->capacity(); ++i) {
+            const uint8_t distance = source->distances[i];
+            if (distance != 0) {
+                if (histogram.size() < distance) {
+                    histogram.resize(distance, 0);
+                }
+                ++histogram[distance - 1];
+            }
+        }
+    }
+    return histogram;
+}
@@ -0,0 +1,139 @@
+#ifndef     _ROBINHOODHASHTABLE_HPP_
+# define    _ROBINHOODHASHTABLE_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+# include "Bid.hpp"
+
+/**
+ * How a RobinHoodHashTable grows. eREHASH_INCREMENTAL keeps the old slot
+ * array next to the new one and moves MIGRATE_STEP old slots per
+ * operation; eREHASH_ALL_AT_ONCE moves every entry inside the insert
+ * that crossed the load factor.
+ */
+enum RehashMode {
+    eREHASH_INCREMENTAL = 0,
+    eREHASH_ALL_AT_ONCE = 1
+};
+
+/**
+ * Open-addressing hash table of bids keyed by bidId as a uint32_t.
+ *
+ *  - keys go through a murmur3 finalizer, so sequential ids spread over
+ *    a power-of-two table and the bucket is a mask rather than a modulo,
+ *  - Robin Hood probing: an entry that is further from its home slot
+ *    than the one in its way takes the slot, which keeps probe lengths
+ *    short and lets a lookup stop as soon as it meets an entry closer to
+ *    home than the key would be,
+ *  - Remove shifts the following entries back one slot (no tombstones),
+ *  - the table doubles once it would pass the maximum load factor.
+ *
+ * Slots are 8 bytes (key + index of the bid) with the probe distances in
+ * a separate byte array, so a probe sequence is read from one or two
+ * cache lines. Bids are constructed in place in fixed-size chunks that
+ * never move, and slot arrays come zeroed from calloc, so growing never
+ * touches more than a bounded amount of memory in one operation when
+ * rehashing incrementally. Inserting an id already present replaces
+ * that bid. Bids whose id is not a plain number are rejected.
+ */
+class RobinHoodHashTable {
+
+private:
+    struct Slot {
+        std::uint32_t key;
+        std::uint32_t record;
+    };
+
+    struct Table {
+        // distance from home + 1, 0 for an empty slot
+        std::uint8_t* distances = nullptr;
+        Slot* slots = nullptr;
+        std::size_t mask = 0;
+
+        std::size_t capacity() const { return slots == nullptr ? 0 : mask + 1; }
+    };
+
+    static const std::size_t RECORD_CHUNK = 4096;
+
+    Table table;
+    // the table being emptied into table while rehashing incrementally;
+    // slots [migrateStart, migrateStart + migrated) (wrapping) are done
+    Table old;
+    std::size_t migrateStart;
+    std::size_t migrated;
+
+    // raw storage for RECORD_CHUNK bids each; the first recordCount are constructed
+    std::vector<Bid*> recordChunks;
+    std::size_t recordCount;
+    double maxLoadFactor;
+    RehashMode mode;
+
+    static std::uint32_t mix(std::uint32_t key);
+    static void allocate(Table& t, std::size_t capacity);
+    static void release(Table& t);
+    static std::size_t findIn(const Table& t, std::uint32_t key);
+    static std::size_t findFrom(const Table& t, std::uint32_t key, std::size_t home);
+    static bool placeIn(Table& t, std::uint32_t& key, std::uint32_t& record);
+    static void removeAt(Table& t, std::size_t i);
+
+    Bid& record(std::uint32_t index) const;
+    std::size_t findInOld(std::uint32_t key) const;
+    Slot* findSlot(std::uint32_t key) const;
+    unsigned distanceOf(const Slot* slot) const;
+    void migrate(std::size_t steps);
+    void grow();
+    void rebuild(std::size_t capacity, const Slot* homeless = nullptr);
+
+public:
+    // a probe distance of 255 forces growth, so the byte can't overflow
+    static const std::uint8_t MAX_DISTANCE = 255;
+    // old slots moved per operation while rehashing incrementally
+    static const std::size_t MIGRATE_STEP = 64;
+    // keys whose home slots SearchBatch prefetches before probing any of them
+    static const std::size_t BATCH_GROUP = 16;
+
+    explicit RobinHoodHashTable(double maxLoadFactor = 0.875, std::size_t initialCapacity = 16,
+                                RehashMode mode = eREHASH_INCREMENTAL);
+    virtual ~RobinHoodHashTable();
+    RobinHoodHashTable(const RobinHoodHashTable&) = delete;
+    RobinHoodHashTable& operator=(const RobinHoodHashTable&) = delete;
+
+    bool Insert(Bid bid);
+    void PrintAll() const;
+    bool Remove(std::string bidId);
+    Bid Search(std::string bidId);
+    const Bid* Find(std::uint32_t key);
+    // Find without moving any slots along, so readers can share the table
+    const Bid* Find(std::uint32_t key) const;
+
+    /**
+     * Look up count keys at once. Keys go through in groups of
+     * BATCH_GROUP: the home slots of the whole group are prefetched
+     * first, then probed, so the cache misses of a group overlap instead
+     * of each lookup waiting for its own. Found bids are prefetched too.
+     *
+     * @param keys numeric bid ids
+     * @param count number of keys
+     * @param out count entries, set to the bid found or nullptr
+     */
+    void SearchBatch(const std::uint32_t* keys, std::size_t count, const Bid** out) const;
+    void Clear();
+
+    std::size_t Size() const { return recordCount; }
+    std::size_t Capacity() const { return table.capacity(); }
+    double LoadFactor() const { return double(recordCount) / table.capacity(); }
+    bool Rehashing() const { return old.slots != nullptr; }
+    // bytes held by the slot arrays and bid chunks, not counting the bids' strings
+    std::size_t MemoryBytes() const;
+
+    /**
+     * How many entries sit at each distance from their home slot
+     *
+     * @return counts, index 0 for entries in their home slot
+     */
+    std::vector<std::size_t> ProbeHistogram() const;
+};
+
+#endif /*!_ROBINHOODHASHTABLE_HPP_*/
@@ -0,0 +1,413 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <random>
+#include "CSVparser.hpp"
+#include "BidSnapshot.hpp"
+#include "CSVreader.hpp"
+#include "Currency.hpp"
+#include "SalesAggregation.hpp"
+#include "ThreadPool.hpp"
+using namespace std;
+
+namespace {
+
+const char* const MEASURE_NAMES[] = { "winning bid", "fees", "net sales" };
+const char* const GROUP_NAMES[] = { "fund", "department", "month" };
+
+// rows per batch: the slots of a batch stay in L1 between its loops
+const size_t BATCH = 1024;
+
+// copies of each group's totals; neighbouring rows of one group update
+// different copies, so they don't wait on each other's stores
+const size_t LANES = 4;
+
+/**
+ * One thread's totals so far: an open-addressing table from group key
+ * to slot, and every aggregate as an array indexed by slot * LANES plus
+ * a lane, so the update loops touch one array each
+ */
+class PartialTotals {
+    // slot + 1 at each hash position, 0 when empty
+    vector<uint32_t> table;
+    unsigned shift;
+
+    size_t hashOf(uint16_t key) const {
+        return size_t((uint32_t(key) * 2654435761u) >> shift);
+    }
+
+    void place(uint16_t key, uint32_t slot) {
+        size_t i = hashOf(key);
+        while (table[i] != 0) {
+            i = (i + 1) & (table.size() - 1);
+        }
+        table[i] = slot + 1;
+    }
+
+    uint32_t add(uint16_t key) {
+        const uint32_t slot = uint32_t(keys.size());
+        keys.push_back(key);
+        count.resize(count.size() + LANES, 0);
+        for (int m = 0; m < eMEASURES; ++m) {
+            sum[m].resize(sum[m].size() + LANES, 0);
+            min[m].resize(min[m].size() + LANES, numeric_limits<int64_t>::max());
+            max[m].resize(max[m].size() + LANES, numeric_limits<int64_t>::min());
+        }
+        // at most half full
+        if (2 * keys.size() > table.size()) {
+            table.assign(table.size() * 2, 0);
+            --shift;
+            for (uint32_t s = 0; s < keys.size(); ++s) {
+                place(keys[s], s);
+            }
+        }
+        else {
+            place(key, slot);
+        }
+        return slot;
+    }
+
+public:
+    vector<uint16_t> keys;
+    vector<uint64_t> count;
+    vector<int64_t> sum[eMEASURES];
+    vector<int64_t> min[eMEASURES];
+    vector<int64_t> max[eMEASURES];
+
+    PartialTotals() : table(64, 0), shift(32 - 6) {}
+
+    uint32_t SlotOf(uint16_t key) {
+        for (size_t i = hashOf(key);; i = (i + 1) & (table.size() - 1)) {
+            if (table[i] == 0) {
+                return add(key);
+            }
+            if (keys[table[i] - 1] == key) {
+                return table[i] - 1;
+            }
+        }
+    }
+
+    // fold every lane of a slot into totals
+    void AddTo(uint32_t slot, SalesTotals& totals) const {
+        for (size_t i = slot * LANES; i < (slot + 1) * LANES; ++i) {
+            totals.count += count[i];
+            for (int m = 0; m < eMEASURES; ++m) {
+                totals.sum[m] += sum[m][i];
+                totals.min[m] = std::min(totals.min[m], min[m][i]);
+                totals.max[m] = std::max(totals.max[m], max[m][i]);
+            }
+        }
+    }
+};
+
+/**
+ * Add rows [begin, end) to totals a batch at a time: look up the slot of
+ * each row's group once, then run a loop per aggregate over the batch
+ */
+void accumulate(const SalesColumns& columns, SalesGroup group, size_t begin, size_t end, PartialTotals& totals) {
+    const uint16_t* keys = columns.Keys(group);
+    uint32_t slots[BATCH];
+
+    for (size_t first = begin; first < end; first += BATCH) {
+        const size_t n = std::min(BATCH, end - first);
+        // neighbouring rows often share a group; skip the probe for a repeat
+        uint16_t lastKey = keys[first];
+        uint32_t lastSlot = totals.SlotOf(lastKey);
+        for (size_t i = 0; i < n; ++i) {
+            const uint16_t key = keys[first + i];
+            if (key != lastKey) {
+                lastKey = key;
+                lastSlot = totals.SlotOf(key);
+            }
+            slots[i] = uint32_t(lastSlot * LANES + (i & (LANES - 1)));
+        }
+
+        uint64_t* count = totals.count.data();
+        for (size_t i = 0; i < n; ++i) {
+            ++count[slots[i]];
+        }
+        for (int m = 0; m < eMEASURES; ++m) {
+            const int64_t* values = columns.Cents(SalesMeasure(m)) + first;
+            int64_t* sum = totals.sum[m].data();
+            int64_t* low = totals.min[m].data();
+            int64_t* high = totals.max[m].data();
+            for (size_t i = 0; i < n; ++i) {
+                const uint32_t s = slots[i];
+                sum[s] += values[i];
+                low[s] = std::min(low[s], values[i]);
+                high[s] = std::max(high[s], values[i]);
+            }
+        }
+    }
+}
+
+// a header cell without its blanks, so "Close Date " and "CloseDate" match
+string squeeze(string_view name) {
+    string out;
+    for (char c : name) {
+        if (c != ' ' && c != '\r') {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+bool readNumber(string_view text, unsigned& value) {
+    const char* end = text.data() + text.size();
+    from_chars_result result = from_chars(text.data(), end, value);
+    return !text.empty() && result.ec == errc() && result.ptr == end;
+}
+}
+
+const char* salesMeasureName(SalesMeasure measure) {
+    return MEASURE_NAMES[measure];
+}
+
+const char* salesGroupName(SalesGroup group) {
+    return GROUP_NAMES[group];
+}
+
+uint16_t monthKey(string_view closeDate) {
+    while (!closeDate.empty() && (closeDate.back() == ' ' || closeDate.back() == '"')) {
+        closeDate.remove_suffix(1);
+    }
+    while (!closeDate.empty() && (closeDate.front() == ' ' || closeDate.front() == '"')) {
+        closeDate.remove_prefix(1);
+    }
+    const size_t slash1 = closeDate.find('/');
+    const size_t slash2 = slash1 == string_view::npos ? slash1 : closeDate.find('/', slash1 + 1);
+    unsigned month, day, year;
+    if (slash2 == string_view::npos || !readNumber(closeDate.substr(0, slash1), month)
+        || !readNumber(closeDate.substr(slash1 + 1, slash2 - slash1 - 1), day)
+        || !readNumber(closeDate.substr(slash2 + 1), year) || month < 1 || month > 12) {
+        return 0;
+    }
+    if (year < 100) {
+        year += 2000;
+    }
+    return year > 5000 ? 0 : uint16_t(year * 12 + month - 1);
+}
+
+uint16_t SalesColumns::intern(SalesGroup group, string_view name) {
+    const string key(name);
+    unordered_map<string, uint16_t>::const_iterator found = codes[group].find(key);
+    if (found != codes[group].end()) {
+        return found->second;
+    }
+    if (names[group].size() > 0xFFFF) {
+        throw csv::Error(string("more than 65536 distinct values of ") + GROUP_NAMES[group]);
+    }
+    const uint16_t code = uint16_t(names[group].size());
+    names[group].push_back(key);
+    codes[group].emplace(key, code);
+    return code;
+}
+
+void SalesColumns::Append(string_view fund, string_view department, uint16_t month,
+                          const int64_t amounts[eMEASURES]) {
+    keys[eGROUP_FUND].push_back(intern(eGROUP_FUND, fund));
+    keys[eGROUP_DEPARTMENT].push_back(intern(eGROUP_DEPARTMENT, department));
+    keys[eGROUP_MONTH].push_back(month);
+    for (int m = 0; m < eMEASURES; ++m) {
+        cents[m].push_back(amounts[m]);
+    }
+}
+
+void SalesColumns::Reserve(size_t rows) {
+    for (vector<int64_t>& column : cents) {
+        column.reserve(rows);
+    }
+    for (vector<uint16_t>& column : keys) {
+        column.reserve(rows);
+    }
+}
+
+SalesColumns SalesColumns::Resample(size_t rows, unsigned seed) const {
+    SalesColumns sample;
+    for (int g = 0; g < eGROUPS; ++g) {
+        sample.names[g] = names[g];
+        sample.codes[g] = codes[g];
+    }
+    if (Size() == 0) {
+        return sample;
+    }
+    sample.Reserve(rows);
+    mt19937 random(seed);
+    uniform_int_distribution<size_t> pick(0, Size() - 1);
+    for (size_t i = 0; i < rows; ++i) {
+        const size_t row = pick(random);
+        for (int m = 0; m < eMEASURES; ++m) {
+            sample.cents[m].push_back(cents[m][row]);
+        }
+        for (int g = 0; g < eGROUPS; ++g) {
+            sample.keys[g].push_back(keys[g][row]);
+        }
+    }
+    return sample;
+}
+
+string SalesColumns::KeyName(SalesGroup group, uint16_t key) const {
+    if (group == eGROUP_MONTH) {
+        if (key == 0) {
+            return "(no date)";
+        }
+        char text[16];
+        snprintf(text, sizeof(text), "%u-%02u", unsigned(key / 12), unsigned(key % 12 + 1));
+        return text;
+    }
+    return names[group][key].empty() ? "(none)" : names[group][key];
+}
+
+size_t SalesColumns::MemoryBytes() const {
+    size_t bytes = sizeof(*this);
+    for (const vector<int64_t>& column : cents) {
+        bytes += column.capacity() * sizeof(int64_t);
+    }
+    for (const vector<uint16_t>& column : keys) {
+        bytes += column.capacity() * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+unsigned int loadSalesColumns(const string& csvPath, SalesColumns& columns) {
+    const size_t NO_COLUMN = size_t(-1);
+    csv::MappedFile file(csvPath);
+    // a snapshot keeps no dates, fees or net sales to total
+    BidSnapshot::RequireCsv(file.view(), csvPath);
+    csv::Reader reader(file.view());
+    vector<string_view> fields;
+    string fundScratch, departmentScratch;
+    unsigned int count = 0;
+
+    if (!reader.next(fields)) {
+        throw csv::Error(string("No Data in ").append(csvPath));
+    }
+    const size_t columnCount = fields.size();
+    size_t fund = NO_COLUMN, department = NO_COLUMN, closeDate = NO_COLUMN;
+    size_t measures[eMEASURES] = { NO_COLUMN, NO_COLUMN, NO_COLUMN };
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const string name = squeeze(fields[i]);
+        if (name == "Fund") {
+            fund = i;
+        }
+        else if (name == "Department") {
+            department = i;
+        }
+        else if (name == "CloseDate") {
+            closeDate = i;
+        }
+        else if (name == "WinningBid") {
+            measures[eMEASURE_WINNING_BID] = i;
+        }
+        else if (name == "AuctionFeeTotal") {
+            measures[eMEASURE_FEES] = i;
+        }
+        else if (name == "NetSales") {
+            measures[eMEASURE_NET_SALES] = i;
+        }
+    }
+
+    while (reader.next(fields)) {
+        if (fields.size() != columnCount) {
+            throw csv::Error("corrupted data !");
+        }
+        int64_t amounts[eMEASURES] = {};
+        for (int m = 0; m < eMEASURES; ++m) {
+            if (measures[m] != NO_COLUMN) {
+                parseCents(fields[measures[m]], amounts[m]);
+            }
+        }
+        columns.Append(fund == NO_COLUMN ? string_view() : csv::unquote(fields[fund], fundScratch),
+                       department == NO_COLUMN ? string_view() : csv::unquote(fields[department], departmentScratch),
+                       closeDate == NO_COLUMN ? 0 : monthKey(fields[closeDate]), amounts);
+        ++count;
+    }
+    return count;
+}
+
+bool SalesTotals::operator==(const SalesTotals& other) const {
+    return key == other.key && count == other.count && equal(sum, sum + eMEASURES, other.sum)
+        && equal(min, min + eMEASURES, other.min) && equal(max, max + eMEASURES, other.max);
+}
+
+vector<SalesTotals> aggregateSales(const SalesColumns& columns, SalesGroup group, unsigned threads) {
+    const size_t rows = columns.Size();
+    if (threads == 0) {
+        threads = ThreadPool::DefaultThreads();
+    }
+    // at least a few batches a thread, or the merge costs more than it saves
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(threads, rows / (16 * BATCH)));
+    vector<PartialTotals> partials(parts);
+    if (parts == 1) {
+        accumulate(columns, group, 0, rows, partials[0]);
+    }
+    else {
+        ThreadPool pool(static_cast<unsigned>(parts));
+        for (size_t p = 0; p < parts; ++p) {
+            pool.Submit([&columns, &partials, group, rows, parts, p]() {
+                accumulate(columns, group, rows * p / parts, rows * (p + 1) / parts, partials[p]);
+            });
+        }
+        pool.Wait();
+    }
+
+    // merge the partials; a key is 16 bits, so index their totals directly
+    vector<SalesTotals> totals;
+    vector<uint32_t> totalOf(size_t(1) << 16, 0);
+    for (const PartialTotals& partial : partials) {
+        for (uint32_t s = 0; s < partial.keys.size(); ++s) {
+            uint32_t& t = totalOf[partial.keys[s]];
+            if (t == 0) {
+                totals.emplace_back();
+                totals.back().key = partial.keys[s];
+                t = uint32_t(totals.size());
+            }
+            partial.AddTo(s, totals[t - 1]);
+        }
+    }
+    sort(totals.begin(), totals.end(), [](const SalesTotals& a, const SalesTotals& b) {
+        return a.key < b.key;
+    });
+    return totals;
+}
+
+vector<SalesTotals> aggregateSalesReference(const SalesColumns& columns, SalesGroup group) {
+    map<uint16_t, SalesTotals> groups;
+    for (size_t row = 0; row < columns.Size(); ++row) {
+        SalesTotals& t = groups[columns.Keys(group)[row]];
+        ++t.count;
+        for (int m = 0; m < eMEASURES; ++m) {
+            const int64_t value = columns.Cents(SalesMeasure(m))[row];
+            t.sum[m] += value;
+            t.min[m] = std::min(t.min[m], value);
+            t.max[m] = std::max(t.max[m], value);
+        }
+    }
+    vector<SalesTotals> totals;
+    for (map<uint16_t, SalesTotals>::value_type& g : groups) {
+        g.second.key = g.first;
+        totals.push_back(g.second);
+    }
+    return totals;
+}
+
+void printSalesTotals(ostream& out, const SalesColumns& columns, SalesGroup group, SalesMeasure measure,
+                      const vector<SalesTotals>& totals) {
+    out << left << setw(40) << salesGroupName(group) << right << setw(8) << "bids" << setw(22)
+        << (string("total ") + salesMeasureName(measure)) << setw(12) << "average" << setw(12) << "min"
+        << setw(14) << "max" << endl;
+    uint64_t count = 0;
+    int64_t sum = 0;
+    for (const SalesTotals& t : totals) {
+        out << left << setw(40) << columns.KeyName(group, t.key).substr(0, 39) << right << setw(8) << t.count
+            << setw(22) << formatCents(t.sum[measure]) << setw(12)
+            << formatCents(int64_t(llround(t.AverageCents(measure)))) << setw(12) << formatCents(t.min[measure])
+            << setw(14) << formatCents(t.max[measure]) << endl;
+        count += t.count;
+        sum += t.sum[measure];
+    }
+    out << left << setw(40) << "all" << right << setw(8) << count << setw(22) << formatCents(sum) << endl;
+}
@@ -0,0 +1,128 @@
+#ifndef     _SALESAGGREGATION_HPP_
+# define    _SALESAGGREGATION_HPP_
+
+# include <cstddef>
+# include <cstdint>
+# include <limits>
+# include <ostream>
+# include <string>
+# include <string_view>
+# include <unordered_map>
+# include <vector>
+
+// the money columns a report totals
+enum SalesMeasure {
+    eMEASURE_WINNING_BID = 0,
+    eMEASURE_FEES = 1,
+    eMEASURE_NET_SALES = 2,
+    eMEASURES = 3
+};
+
+// what a report groups by
+enum SalesGroup {
+    eGROUP_FUND = 0,
+    eGROUP_DEPARTMENT = 1,
+    eGROUP_MONTH = 2,
+    eGROUPS = 3
+};
+
+const char* salesMeasureName(SalesMeasure measure);
+const char* salesGroupName(SalesGroup group);
+
+/**
+ * Month key of a close date such as 11/26/2013 or 12/1/16: year * 12 +
+ * month - 1, so keys sort by date. 0 when the field is not a date.
+ */
+std::uint16_t monthKey(std::string_view closeDate);
+
+/**
+ * Columnar copy of the fields sales reports need, one array per field:
+ * Winning Bid, Auction Fee Total and Net Sales in whole cents, the fund
+ * and department as dictionary codes, and the month of the Close Date.
+ * A group key is 16 bits whatever it groups by.
+ */
+class SalesColumns {
+
+private:
+    std::vector<std::int64_t> cents[eMEASURES];
+    std::vector<std::uint16_t> keys[eGROUPS];
+    // fund and department names by code
+    std::vector<std::string> names[eGROUPS];
+    std::unordered_map<std::string, std::uint16_t> codes[eGROUPS];
+
+    std::uint16_t intern(SalesGroup group, std::string_view name);
+
+public:
+    /**
+     * Add one bid
+     *
+     * @throws csv::Error past 65536 distinct funds or departments
+     */
+    void Append(std::string_view fund, std::string_view department, std::uint16_t month,
+                const std::int64_t amounts[eMEASURES]);
+    void Reserve(std::size_t rows);
+
+    /**
+     * rows bids picked at random from these, with the same dictionaries,
+     * for tests at sizes the CSV files don't reach
+     */
+    SalesColumns Resample(std::size_t rows, unsigned seed) const;
+
+    std::size_t Size() const { return keys[eGROUP_FUND].size(); }
+    const std::int64_t* Cents(SalesMeasure measure) const { return cents[measure].data(); }
+    const std::uint16_t* Keys(SalesGroup group) const { return keys[group].data(); }
+    // a fund or department name, or a month as 2013-11
+    std::string KeyName(SalesGroup group, std::uint16_t key) const;
+    std::size_t MemoryBytes() const;
+};
+
+/**
+ * Read the columns of a CSV export. Any of them the file doesn't have,
+ * like the fees in the December export, reads as 0 or empty.
+ *
+ * @return the number of bids read
+ * @throws csv::Error if the file can't be read, is a snapshot or a record
+ *         is malformed
+ */
+unsigned int loadSalesColumns(const std::string& csvPath, SalesColumns& columns);
+
+/**
+ * COUNT, and SUM, MIN and MAX of every measure, for one group. Sums are
+ * exact in cents; AVG is Sum / Count.
+ */
+struct SalesTotals {
+    std::uint16_t key = 0;
+    std::uint64_t count = 0;
+    std::int64_t sum[eMEASURES] = {};
+    std::int64_t min[eMEASURES] = { std::numeric_limits<std::int64_t>::max(),
+                                    std::numeric_limits<std::int64_t>::max(),
+                                    std::numeric_limits<std::int64_t>::max() };
+    std::int64_t max[eMEASURES] = { std::numeric_limits<std::int64_t>::min(),
+                                    std::numeric_limits<std::int64_t>::min(),
+                                    std::numeric_limits<std::int64_t>::min() };
+
+    double AverageCents(SalesMeasure measure) const {
+        return count == 0 ? 0.0 : double(sum[measure]) / double(count);
+    }
+    bool operator==(const SalesTotals& other) const;
+};
+
+/**
+ * Totals per group, lowest key first, by hash aggregation. The rows are
+ * split between threads; each fills its own table of partial totals in
+ * batches, first finding the slot of every row's group and then running
+ * one tight loop per aggregate over the batch. The tables are merged at
+ * the end.
+ *
+ * @param threads 0 for one per core
+ */
+std::vector<SalesTotals> aggregateSales(const SalesColumns& columns, SalesGroup group, unsigned threads = 0);
+
+// the same totals a row at a time into a std::map, to check aggregateSales against
+std::vector<SalesTotals> aggregateSalesReference(const SalesColumns& columns, SalesGroup group);
+
+// a table of one measure's totals, a row per group
+void printSalesTotals(std::ostream& out, const SalesColumns& columns, SalesGroup group, SalesMeasure measure,
+                      const std::vector<SalesTotals>& totals);
+
+#endif /*!_SALESAGGREGATION_HPP_*/
@@ -0,0 +1,330 @@
+#ifndef     _SORTENGINE_HPP_
+# define    _SORTENGINE_HPP_
+
+# include <algorithm>
+# include <cstddef>
+# include <iterator>
+# include <string_view>
+# include <utility>
+# include "Bid.hpp"
+
+/**
+ * Pattern-defeating quicksort (pdqsort, Orson Peters) for the vector
+ * path. Compared to quickSort() it
+ *  - picks the pivot as median of 3, or a ninther above 128 elements,
+ *  - finishes ranges below 24 elements with insertion sort,
+ *  - recurses into the smaller side only, so stack depth is O(log n),
+ *  - shuffles a few elements after a badly unbalanced partition and
+ *    falls back to heapsort after log2(n) of them, so it is O(n log n),
+ *  - puts runs equal to the previous pivot aside in one pass, which
+ *    makes inputs with many duplicates linear,
+ *  - notices ranges that are already sorted and stops early,
+ *  - only ever moves elements, never copies them.
+ */
+
+namespace pdqdetail {
+
+const std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+const std::ptrdiff_t NINTHER_THRESHOLD = 128;
+const std::size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+template <class Iter, class Compare>
+void insertionSort(Iter begin, Iter end, Compare comp) {
+    if (begin == end) {
+        return;
+    }
+    for (Iter cur = begin + 1; cur != end; ++cur) {
+        if (comp(*cur, *(cur - 1))) {
+            auto tmp = std::move(*cur);
+            Iter sift = cur;
+            do {
+                *sift = std::move(*(sift - 1));
+                --sift;
+            } while (sift != begin && comp(tmp, *(sift - 1)));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// the element before begin is known to be <= everything in the range
+template <class Iter, class Compare>
+void unguardedInsertionSort(Iter begin, Iter end, Compare comp) {
+    if (begin == end) {
+        return;
+    }
+    for (Iter cur = begin + 1; cur != end; ++cur) {
+        if (comp(*cur, *(cur - 1))) {
+            auto tmp = std::move(*cur);
+            Iter sift = cur;
+            do {
+                *sift = std::move(*(sift - 1));
+                --sift;
+            } while (comp(tmp, *(sift - 1)));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// insertion sort that gives up after a few moves; true if it finished
+template <class Iter, class Compare>
+bool partialInsertionSort(Iter begin, Iter end, Compare comp) {
+    if (begin == end) {
+        return true;
+    }
+    std::size_t moved = 0;
+    for (Iter cur = begin + 1; cur != end; ++cur) {
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+        if (comp(*cur, *(cur - 1))) {
+            auto tmp = std::move(*cur);
+            Iter sift = cur;
+            do {
+                *sift = std::move(*(sift - 1));
+                --sift;
+            } while (sift != begin && comp(tmp, *(sift - 1)));
+            *sift = std::move(tmp);
+            moved += cur - sift;
+        }
+    }
+    return true;
+}
+
+template <class Iter, class Compare>
+inline void sort2(Iter a, Iter b, Compare comp) {
+    if (comp(*b, *a)) {
+        std::iter_swap(a, b);
+    }
+}
+
+template <class Iter, class Compare>
+inline void sort3(Iter a, Iter b, Iter c, Compare comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+/**
+ * Partition around *begin, elements equal to the pivot go right.
+ * Needs an element >= pivot somewhere after begin (median of 3 makes
+ * sure of that).
+ *
+ * @return final pivot position and whether nothing had to be swapped
+ */
+template <class Iter, class Compare>
+std::pair<Iter, bool> partitionRight(Iter begin, Iter end, Compare comp) {
+    auto pivot = std::move(*begin);
+    Iter first = begin;
+    Iter last = end;
+
+    while (comp(*++first, pivot)) {
+    }
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {
+        }
+    }
+    else {
+        while (!comp(*--last, pivot)) {
+        }
+    }
+
+    const bool alreadyPartitioned = first >= last;
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot)) {
+        }
+        while (!comp(*--last, pivot)) {
+        }
+    }
+
+    Iter pivotPos = first - 1;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return std::make_pair(pivotPos, alreadyPartitioned);
+}
+
+/**
+ * Partition around *begin with elements equal to the pivot going left.
+ * Used when the pivot equals the element before the range, so the whole
+ * left part is one run of equal keys that needs no more sorting.
+ */
+template <class Iter, class Compare>
+Iter partitionLeft(Iter begin, Iter end, Compare comp) {
+    auto pivot = std::move(*begin);
+    Iter first = begin;
+    Iter last = end;
+
+    while (comp(pivot, *--last)) {
+    }
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {
+        }
+    }
+    else {
+        while (!comp(pivot, *++first)) {
+        }
+    }
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last)) {
+        }
+        while (!comp(pivot, *++first)) {
+        }
+    }
+
+    Iter pivotPos = last;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return pivotPos;
+}
+
+template <class Iter, class Compare>
+void pdqLoop(Iter begin, Iter end, Compare comp, int badAllowed, bool leftmost) {
+    typedef typename std::iterator_traits<Iter>::difference_type diff_t;
+
+    for (;;) {
+        const diff_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost) {
+                insertionSort(begin, end, comp);
+            }
+            else {
+                unguardedInsertionSort(begin, end, comp);
+            }
+            return;
+        }
+
+        // move the median of 3 (or ninther) to begin
+        const diff_t half = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + half, end - 1, comp);
+            sort3(begin + 1, begin + (half - 1), end - 2, comp);
+            sort3(begin + 2, begin + (half + 1), end - 3, comp);
+            sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+            std::iter_swap(begin, begin + half);
+        }
+        else {
+            sort3(begin + half, begin, end - 1, comp);
+        }
+
+        // pivot equal to the element before us: take the equal run in one go
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partitionLeft(begin, end, comp) + 1;
+            continue;
+        }
+
+        std::pair<Iter, bool> part = partitionRight(begin, end, comp);
+        Iter pivotPos = part.first;
+        const diff_t leftSize = pivotPos - begin;
+        const diff_t rightSize = end - (pivotPos + 1);
+
+        if (leftSize < size / 8 || rightSize < size / 8) {
+            if (--badAllowed == 0) {
+                std::make_heap(begin, end, comp);
+                std::sort_heap(begin, end, comp);
+                return;
+            }
+
+            // break up patterns that keep producing bad pivots
+            if (leftSize >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(begin, begin + leftSize / 4);
+                std::iter_swap(pivotPos - 1, pivotPos - leftSize / 4);
+                if (leftSize > NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+                    std::iter_swap(pivotPos - 2, pivotPos - (leftSize / 4 + 1));
+                    std::iter_swap(pivotPos - 3, pivotPos - (leftSize / 4 + 2));
+                }
+            }
+            if (rightSize >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(pivotPos + 1, pivotPos + (1 + rightSize / 4));
+                std::iter_swap(end - 1, end - rightSize / 4);
+                if (rightSize > NINTHER_THRESHOLD) {
+                    std::iter_swap(pivotPos + 2, pivotPos + (2 + rightSize / 4));
+                    std::iter_swap(pivotPos + 3, pivotPos + (3 + rightSize / 4));
+                    std::iter_swap(end - 2, end - (1 + rightSize / 4));
+                    std::iter_swap(end - 3, end - (2 + rightSize / 4));
+                }
+            }
+        }
+        else if (part.second && partialInsertionSort(begin, pivotPos, comp)
+            && partialInsertionSort(pivotPos + 1, end, comp)) {
+            // nothing was out of place, this range was (nearly) sorted
+            return;
+        }
+
+        // recurse into the smaller side and loop on the larger one
+        if (leftSize < rightSize) {
+            pdqLoop(begin, pivotPos, comp, badAllowed, leftmost);
+            begin = pivotPos + 1;
+            leftmost = false;
+        }
+        else {
+            pdqLoop(pivotPos + 1, end, comp, badAllowed, false);
+            end = pivotPos;
+        }
+    }
+}
+
+}
+
+/**
+ * Sort [begin, end) with pdqsort. Not stable.
+ *
+ * @param comp strict weak ordering, comp(a, b) true when a goes first
+ */
+template <class Iter, class Compare>
+void pdqSort(Iter begin, Iter end, Compare comp) {
+    std::ptrdiff_t size = end - begin;
+    int log2 = 0;
+    while (size > 1) {
+        size >>= 1;
+        ++log2;
+    }
+    if (begin != end) {
+        pdqdetail::pdqLoop(begin, end, comp, log2 + 1, true);
+    }
+}
+
+/**
+ * Sort [begin, end) ascending by key(element)
+ *
+ * @param key extractor, e.g. BidTitleKey(); its result needs operator<
+ */
+template <class Iter, class KeyFn>
+void pdqSortBy(Iter begin, Iter end, KeyFn key) {
+    pdqSort(begin, end, [&key](const auto& a, const auto& b) {
+        return key(a) < key(b);
+    });
+}
+
+// Key extractors for Bid; they return views so comparisons copy nothing
+
+struct BidTitleKey {
+    std::string_view operator()(const Bid& bid) const { return bid.title; }
+};
+
+struct BidFundKey {
+    std::string_view operator()(const Bid& bid) const { return bid.fund; }
+};
+
+struct BidAmountKey {
+    double operator()(const Bid& bid) const { return bid.amount; }
+};
+
+// numeric order for digit-only ids without parsing: shorter is smaller
+struct BidIdKey {
+    std::pair<std::size_t, std::string_view> operator()(const Bid& bid) const {
+        return std::make_pair(bid.bidId.size(), std::string_view(bid.bidId));
+    }
+};
+
+// title, then id for equal titles: a total order, so any sort gives the same result
+struct BidTitleIdKey {
+    std::pair<std::string_view, std::pair<std::size_t, std::string_view>> operator()(const Bid& bid) const {
+        return std::make_pair(std::string_view(bid.title), BidIdKey()(bid));
+    }
+};
+
+#endif /*!_SORTENGINE_HPP_*/
@@ -0,0 +1,93 @@
+#include "ThreadPool.hpp"
+
+/**
+ * Start the workers
+ *
+ * @param threads number of workers, 0 for DefaultThreads()
+ */
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = DefaultThreads();
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * Destructor, finishes queued tasks and joins the workers
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::DefaultThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+unsigned ThreadPool::Size() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+/**
+ * Queue a task for the next free worker
+ */
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        tasks.push_back(std::move(task));
+        ++pending;
+    }
+    taskReady.notify_one();
+}
+
+/**
+ * Block until the queue is drained and every running task returned
+ */
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    allDone.wait(guard, [this] { return pending == 0; });
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            taskReady.wait(guard, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try {
+            task();
+        }
+        catch (...) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+
+        std::unique_lock<std::mutex> guard(lock);
+        if (--pending == 0) {
+            allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef     _THREADPOOL_HPP_
+# define    _THREADPOOL_HPP_
+
+# include <condition_variable>
+# include <cstddef>
+# include <deque>
+# include <exception>
+# include <functional>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+/**
+ * Fixed set of worker threads pulling tasks off one shared queue.
+ * Wait() blocks until every submitted task has run and rethrows the
+ * first exception a task threw.
+ */
+class ThreadPool {
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex lock;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    std::size_t pending = 0;
+    bool stopping = false;
+    std::exception_ptr firstError;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(unsigned threads = 0);
+    virtual ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task);
+    void Wait();
+    unsigned Size() const;
+
+    // hardware_concurrency(), or 1 when the platform can't tell
+    static unsigned DefaultThreads();
+};
+
+#endif /*!_THREADPOOL_HPP_*/
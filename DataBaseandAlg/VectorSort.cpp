@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "IndexSort.hpp"
+#include "SortEngine.hpp"
+#include "ThreadPool.hpp"
+#include "VectorSort.hpp"
+using namespace std;
+
+/**
+ * Partition the vector of bids into two parts, low and high
+ *
+ * @param bids Address of the vector<Bid> instance to be partitioned
+ * @param begin Beginning index to partition
+ * @param end Ending index to partition
+ */
+int partition(vector<Bid>& bids, int begin, int end)
+{
+    Bid temp;
+    bool done = false;
+
+    // sets mid to pivot
+    int mid = begin + (end - begin) / 2;
+    Bid pivot = bids.at(mid);
+    int l = begin;
+    int h = end;
+
+    while (!done)
+    {
+        // Incrament l while bids[l] < pivot
+        while (bids.at(l).title.compare(pivot.title) < 0)
+        {
+            ++l;
+        }
+        // decrement h while bids[h] > pivot
+        while (pivot.title.compare(bids.at(h).title) < 0)
+        {
+            --h;
+        }
+        // checks for 1 or 0 elements remaning, if true, return h
+        if (l >= h)
+        {
+            done = true;
+        }
+        // if false swap bids[l] with bids[h]
+        else
+        {
+            temp = bids.at(l);
+            bids.at(l) = bids.at(h);
+            bids.at(h) = temp;
+
+            ++l;
+            --h;
+        }
+    }
+    return h;
+}
+
+/**
+ * Perform a quick sort on bid title
+ * Average performance: O(n log(n))
+ * Worst case performance O(n^2))
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ */
+void quickSort(vector<Bid>& bids, int begin, int end) {
+    // already sorted
+    if (begin >= end)
+    {
+        return;
+    }
+
+    int pivot = partition(bids, begin, end);
+
+    quickSort(bids, begin, pivot);
+    quickSort(bids, pivot + 1, end);
+
+    return;
+}
+
+/**
+ * Perform a selection sort on bid title
+ * Worst case performance O(n^2))
+ *
+ * @param bid address of the vector<Bid>
+ *            instance to be sorted
+ */
+void selectionSort(vector<Bid>& bids) {
+    int smallInd = 0;
+    Bid temp;
+
+    for (unsigned int i = 0; i < bids.size(); ++i)
+    {
+        smallInd = i;
+        for (unsigned int j = i + 1; j < bids.size(); ++j)
+        {
+            if (bids.at(j).title.compare(bids.at(smallInd).title) < 0)
+            {
+                smallInd = j;
+            }
+        }
+        temp = bids.at(i);
+        bids.at(i) = bids.at(smallInd);
+        bids.at(smallInd) = temp;
+    }
+}
+
+// below this many bids a single pdqSort beats the setup cost
+const size_t PARALLEL_SORT_CUTOFF = 1 << 16;
+// sample size per bucket; more evens out the buckets
+const size_t SAMPLES_PER_BUCKET = 64;
+
+void parallelSort(vector<Bid>& bids, unsigned threads) {
+    ThreadPool pool(threads);
+    const size_t n = bids.size();
+    const size_t buckets = pool.Size();
+
+    if (buckets == 1 || n < PARALLEL_SORT_CUTOFF) {
+        pdqSortBy(bids.begin(), bids.end(), BidTitleIdKey());
+        return;
+    }
+
+    // evenly spaced sample -> buckets - 1 splitters
+    vector<string> sample;
+    const size_t sampleSize = buckets * SAMPLES_PER_BUCKET;
+    for (size_t i = 0; i < sampleSize; ++i) {
+        sample.push_back(bids[i * (n / sampleSize)].title);
+    }
+    sort(sample.begin(), sample.end());
+    vector<string> splitters;
+    for (size_t b = 1; b < buckets; ++b) {
+        splitters.push_back(sample[b * SAMPLES_PER_BUCKET]);
+    }
+
+    // each block of the input counts how many of its bids land in each bucket
+    vector<uint32_t> bucketOf(n);
+    vector<vector<size_t>> counts(buckets, vector<size_t>(buckets, 0));
+    for (size_t block = 0; block < buckets; ++block) {
+        pool.Submit([&, block] {
+            const size_t first = n * block / buckets;
+            const size_t last = n * (block + 1) / buckets;
+            for (size_t i = first; i < last; ++i) {
+                size_t b = upper_bound(splitters.begin(), splitters.end(), bids[i].title) - splitters.begin();
+                bucketOf[i] = static_cast<uint32_t>(b);
+                ++counts[block][b];
+            }
+        });
+    }
+    pool.Wait();
+
+    // where each block starts writing inside each bucket
+    vector<size_t> bucketStart(buckets + 1, 0);
+    vector<vector<size_t>> writeAt(buckets, vector<size_t>(buckets, 0));
+    size_t offset = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        bucketStart[b] = offset;
+        for (size_t block = 0; block < buckets; ++block) {
+            writeAt[block][b] = offset;
+            offset += counts[block][b];
+        }
+    }
+    bucketStart[buckets] = n;
+
+    vector<Bid> sorted(n);
+    for (size_t block = 0; block < buckets; ++block) {
+        pool.Submit([&, block] {
+            const size_t first = n * block / buckets;
+            const size_t last = n * (block + 1) / buckets;
+            vector<size_t>& next = writeAt[block];
+            for (size_t i = first; i < last; ++i) {
+                sorted[next[bucketOf[i]]++] = move(bids[i]);
+            }
+        });
+    }
+    pool.Wait();
+
+    for (size_t b = 0; b < buckets; ++b) {
+        pool.Submit([&, b] {
+            pdqSortBy(sorted.begin() + bucketStart[b], sorted.begin() + bucketStart[b + 1], BidTitleIdKey());
+        });
+    }
+    pool.Wait();
+
+    bids.swap(sorted);
+}
+
+// buckets this small finish with insertion sort
+const size_t RADIX_INSERTION_CUTOFF = 32;
+
+namespace {
+
+struct TitleRef {
+    string_view title;
+    uint32_t index;
+};
+
+// 0 for "title ends here", otherwise byte + 1, so shorter titles go first
+inline size_t titleBucket(const TitleRef& ref, size_t depth) {
+    return depth < ref.title.size() ? size_t(static_cast<unsigned char>(ref.title[depth])) + 1 : 0;
+}
+
+// the first depth bytes are equal across the range
+void insertionSortFrom(TitleRef* begin, TitleRef* end, size_t depth) {
+    for (TitleRef* cur = begin + 1; cur < end; ++cur) {
+        TitleRef tmp = *cur;
+        string_view suffix = tmp.title.substr(depth);
+        TitleRef* sift = cur;
+        while (sift != begin && suffix < (sift - 1)->title.substr(depth)) {
+            *sift = *(sift - 1);
+            --sift;
+        }
+        *sift = tmp;
+    }
+}
+
+/**
+ * One MSD level: each title's byte at depth is read once into bytes,
+ * the range is counted and distributed through scratch by those cached
+ * bytes, and each bucket recurses on the next byte. scratch and bytes
+ * run parallel to [begin, end).
+ */
+void msdRadixSort(TitleRef* begin, TitleRef* end, TitleRef* scratch, uint16_t* bytes, size_t depth) {
+    const size_t n = end - begin;
+    if (n < RADIX_INSERTION_CUTOFF) {
+        insertionSortFrom(begin, end, depth);
+        return;
+    }
+
+    // walk over bytes the whole range shares without distributing
+    size_t counts[257];
+    for (;;) {
+        fill(counts, counts + 257, 0);
+        for (size_t i = 0; i < n; ++i) {
+            bytes[i] = static_cast<uint16_t>(titleBucket(begin[i], depth));
+            ++counts[bytes[i]];
+        }
+        if (bytes[0] == 0 || counts[bytes[0]] != n) {
+            break;
+        }
+        ++depth;
+    }
+
+    size_t next[257];
+    size_t offset = 0;
+    for (size_t b = 0; b < 257; ++b) {
+        next[b] = offset;
+        offset += counts[b];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        scratch[next[bytes[i]]++] = begin[i];
+    }
+    copy(scratch, scratch + n, begin);
+
+    // bucket 0 holds titles equal up to their end, nothing left to sort
+    offset = counts[0];
+    for (size_t b = 1; b < 257; ++b) {
+        if (counts[b] > 1) {
+            msdRadixSort(begin + offset, begin + offset + counts[b], scratch + offset, bytes + offset, depth + 1);
+        }
+        offset += counts[b];
+    }
+}
+
+/**
+ * Stable LSD radix sort of (key, index) pairs, one byte per pass.
+ * A pass where every key has the same byte would not move anything and
+ * is skipped.
+ *
+ * @return the indexes in key order
+ */
+template <class Key>
+vector<uint32_t> lsdRadixOrder(vector<pair<Key, uint32_t>>& items) {
+    vector<pair<Key, uint32_t>> scratch(items.size());
+    for (size_t shift = 0; shift < sizeof(Key) * CHAR_BIT; shift += 8) {
+        size_t counts[256] = { 0 };
+        for (const auto& item : items) {
+            ++counts[(item.first >> shift) & 0xFF];
+        }
+        if (counts[(items.front().first >> shift) & 0xFF] == items.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t start = offset;
+            offset += count;
+            count = start;
+        }
+        for (const auto& item : items) {
+            scratch[counts[(item.first >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+
+    vector<uint32_t> order(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        order[i] = items[i].second;
+    }
+    return order;
+}
+
+}
+
+void radixSortByTitle(vector<Bid>& bids) {
+    vector<TitleRef> refs(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        refs[i].title = bids[i].title;
+        refs[i].index = static_cast<uint32_t>(i);
+    }
+    vector<TitleRef> scratch(refs.size());
+    vector<uint16_t> bytes(refs.size());
+    msdRadixSort(refs.data(), refs.data() + refs.size(), scratch.data(), bytes.data(), 0);
+
+    vector<uint32_t> order(refs.size());
+    for (size_t i = 0; i < refs.size(); ++i) {
+        order[i] = refs[i].index;
+    }
+    applyPermutation(bids, order);
+}
+
+void radixSortByBidId(vector<Bid>& bids) {
+    if (bids.empty()) {
+        return;
+    }
+
+    // 33-bit key: non-numeric ids get the top bit and land after every number
+    vector<pair<uint64_t, uint32_t>> items(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        uint32_t value = 0;
+        bool numeric = bidIdToKey(bids[i].bidId, value);
+        items[i] = make_pair(numeric ? uint64_t(value) : (uint64_t(1) << 32), static_cast<uint32_t>(i));
+    }
+    applyPermutation(bids, lsdRadixOrder(items));
+}
+
+void radixSortByAmount(vector<Bid>& bids) {
+    if (bids.empty()) {
+        return;
+    }
+
+    // flipping the sign bit makes two's complement order unsigned order
+    vector<pair<uint64_t, uint32_t>> items(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        int64_t cents = llround(bids[i].amount * 100);
+        items[i] = make_pair(static_cast<uint64_t>(cents) ^ (uint64_t(1) << 63), static_cast<uint32_t>(i));
+    }
+    applyPermutation(bids, lsdRadixOrder(items));
+}
@@ -0,0 +1,84 @@
+#ifndef     _VECTORSORT_HPP_
+# define    _VECTORSORT_HPP_
+
+# include <vector>
+# include "Bid.hpp"
+
+/**
+ * Partition the vector of bids into two parts, low and high
+ *
+ * @param bids Address of the vector<Bid> instance to be partitioned
+ * @param begin Beginning index to partition
+ * @param end Ending index to partition
+ */
+int partition(std::vector<Bid>& bids, int begin, int end);
+
+/**
+ * Perform a quick sort on bid title
+ * Average performance: O(n log(n))
+ * Worst case performance O(n^2))
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ * @param begin the beginning index to sort on
+ * @param end the ending index to sort on
+ */
+void quickSort(std::vector<Bid>& bids, int begin, int end);
+
+/**
+ * Perform a selection sort on bid title
+ * Worst case performance O(n^2))
+ *
+ * @param bid address of the vector<Bid>
+ *            instance to be sorted
+ */
+void selectionSort(std::vector<Bid>& bids);
+
+/**
+ * Perform a parallel sample sort on bid title, equal titles by bid id
+ * Splitters drawn from a sample cut the bids into one bucket per
+ * thread; the buckets are filled in parallel and sorted in parallel
+ * with pdqSort, and their concatenation is the sorted vector. Equal
+ * titles share a bucket and the ids break their ties, so the order is
+ * the same whatever the thread count.
+ * Average performance: O(n log(n) / threads)
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ * @param threads worker count, 0 for every hardware thread
+ */
+void parallelSort(std::vector<Bid>& bids, unsigned threads = 0);
+
+/**
+ * Perform an MSD radix sort on bid title
+ * Each level distributes a range into 256 byte buckets (plus one for
+ * titles that end there) and recurses on the next byte, so a shared
+ * prefix like "Dell Optiplex" is read once per level instead of once
+ * per comparison; bytes the whole range shares are skipped without
+ * distributing. Buckets below a few dozen bids finish with insertion
+ * sort on the remaining suffix. Bids are sorted as 24-byte title
+ * references and moved into place once at the end.
+ * Performance: O(n * average distinguishing prefix length)
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ */
+void radixSortByTitle(std::vector<Bid>& bids);
+
+/**
+ * Perform an LSD radix sort on bid id as an unsigned integer
+ * 8 bits per pass, skipping passes where every key has the same byte.
+ * Ids that are not plain numbers sort last, in input order.
+ * Performance: O(n) per pass, at most 5 passes: the key is 33 bits, and
+ * the fifth pass only runs when some ids are not plain numbers
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ */
+void radixSortByBidId(std::vector<Bid>& bids);
+
+/**
+ * Perform an LSD radix sort on bid amount in whole cents
+ * Performance: O(n) per pass, at most 8 passes
+ *
+ * @param bids address of the vector<Bid> instance to be sorted
+ */
+void radixSortByAmount(std::vector<Bid>& bids);
+
+#endif /*!_VECTORSORT_HPP_*/